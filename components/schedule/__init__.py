@@ -1,6 +1,8 @@
 from logging import config
+import logging
 import esphome.codegen as cg
 import esphome.config_validation as cv
+from esphome import automation
 from esphome.components import sensor
 from esphome.components import time
 from esphome.const import (
@@ -8,7 +10,16 @@ from esphome.const import (
     CONF_ICON,
     CONF_ENTITY_CATEGORY,
     CONF_TIME_ID,
+    CONF_LATITUDE,
+    CONF_LONGITUDE,
+    CONF_TRIGGER_ID,
+    CONF_NAME,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_TOTAL_INCREASING,
 )
+from esphome.core import CORE, ID
+
+_LOGGER = logging.getLogger(__name__)
 
 CODEOWNERS = ["@pebblebed-tech"]
 DEPENDENCIES = ["api", "time"]
@@ -16,16 +27,38 @@ DEPENDENCIES = ["api", "time"]
 # Define a configuration key for the array size
 CONF_SCHEDULE_ID = "schedule_id"
 CONF_MAX_SCHEDULE_SIZE = "max_schedule_size"
+CONF_SCHEDULE_SIZE_LIMIT = "schedule_size_limit"
 CONF_HA_SCHEDULE_ENTITY_ID = "ha_schedule_entity_id"
 CONF_SCHEDULED_DATA_ITEMS = "scheduled_data_items"
 CONF_ITEM_LABEL = "label"
 CONF_ITEM_TYPE = "item_type"
+CONF_SECOND_RESOLUTION = "second_resolution"
+CONF_COMBINED_STORAGE = "combined_storage"
+CONF_COMPRESSED_STORAGE = "compressed_storage"
+CONF_PREFERENCE_SYNC_DELAY = "preference_sync_delay"
+CONF_PREFERENCE_SYNC_MAX_DELAY = "preference_sync_max_delay"
+CONF_PREFERENCE_WRITES = "preference_writes"
+CONF_PREFERENCE_WRITES_SKIPPED = "preference_writes_skipped"
+CONF_DAY_EXCEPTIONS = "day_exceptions"
+CONF_DATE = "date"
+CONF_UNTIL = "until"
+CONF_RUN_AS = "run_as"
+CONF_ROTATION_ENTITY_IDS = "rotation_schedule_entity_ids"
+CONF_ROTATION_WEEK_OFFSET = "rotation_week_offset"
+CONF_ON_BEFORE_EVENT = "on_before_event"
+CONF_LEAD = "lead"
+CONF_EVENT = "event"
 # Note: The following options are only applicable to state-based schedules (switch, climate, etc.)
 # Event-based schedules (button) don't have OFF states or manual modes
 CONF_OFF_BEHAVIOR = "item_behavior_when_off"
 CONF_OFF_VALUE = "item_off_value"
 CONF_MANUAL_BEHAVIOR = "item_behavior_in_manual_on"
 CONF_MANUAL_VALUE = "item_manual_on_value"
+CONF_RAMP = "item_ramp"
+CONF_RAMP_MODE = "mode"
+CONF_RAMP_DURATION = "duration"
+CONF_RAMP_INTERVAL = "interval"
+CONF_RAMP_STEP = "step"
 
 # Define the namespace and the C++ class name
 schedule_ns = cg.esphome_ns.namespace("schedule")
@@ -34,28 +67,113 @@ StateBasedSchedulable = schedule_ns.class_("StateBasedSchedulable", Schedule)
 EventBasedSchedulable = schedule_ns.class_("EventBasedSchedulable", Schedule)
 DataSensor = schedule_ns.class_("DataSensor", sensor.Sensor)
 ArrayPreference = schedule_ns.class_("ArrayPreference", cg.Component)
+ScheduleTickService = schedule_ns.class_("ScheduleTickService", cg.Component)
+SolarTable = schedule_ns.class_("SolarTable")
+ScheduleLeadTrigger = schedule_ns.class_("ScheduleLeadTrigger", automation.Trigger.template())
+
+# Key for the device-wide tick service in CORE.data
+KEY_SCHEDULE = "schedule"
+KEY_TICK_SERVICE = "tick_service"
+KEY_SOLAR_TABLES = "solar_tables"
 
 # Storage type enum for schedule components
 ScheduleStorageType = schedule_ns.enum("ScheduleStorageType")
 STORAGE_TYPES = {
     "STATE_BASED": ScheduleStorageType.STORAGE_TYPE_STATE_BASED,
     "EVENT_BASED": ScheduleStorageType.STORAGE_TYPE_EVENT_BASED,
+    "BITMAP": ScheduleStorageType.STORAGE_TYPE_BITMAP,
 }
 
-def calculate_schedule_array_size(max_entries, storage_type="state"):
+# Minute-of-week bitmap storage: 10080 bits plus a 1-byte format tag
+BITMAP_MINUTES_PER_WEEK = 10080
+BITMAP_STORAGE_BYTES = BITMAP_MINUTES_PER_WEEK // 8 + 1
+
+# Compressed tables: a sorted week of minutes has deltas summing to at most 10079, so at most
+# 10079 // 128 tokens need a second byte; allow one 4-byte escape for a slot wrapping the week end
+COMPRESSED_HEADER_BYTES = 3
+COMPRESSED_TWO_BYTE_TOKENS = (BITMAP_MINUTES_PER_WEEK - 1) // 128
+COMPRESSED_ESCAPE_BYTES = 4
+
+def calculate_schedule_array_size(max_entries, storage_type="state", second_resolution=False, rotation_weeks=1,
+                                  repeat_windows=0, compressed=False):
 # Calculate array preference size based on storage type.
+# With compressed=True the worst case of the delta/varint table format is returned instead of the raw size.
     if storage_type == 'state' or storage_type == 'state_based':
         # State-based: [ON, OFF] pairs + [0xFFFF, 0xFFFF] terminator
         multiplier = 2
     elif storage_type == 'event' or storage_type == 'event_based':
-        # Event-based: [EVENT] singles + [0xFFFF] terminator  
+        # Event-based: [EVENT] singles + [0xFFFF, 0xFFFF] terminator
         multiplier = 1
+    elif storage_type == 'bitmap':
+        # Bitmap: fixed size regardless of the number of entries
+        return BITMAP_STORAGE_BYTES
+    elif storage_type == 'bitmap_rle':
+        # Run-length encoded bitmap: one uint16_t run per transition (2 per entry) plus the
+        # leading OFF run, capped at the raw bitmap size which is used when runs do not fit
+        return min(1 + (max_entries * 2 + 1) * 2, BITMAP_STORAGE_BYTES)
     else:
-        raise ValueError(f"Unknown storage type: {storage_type}. Use 'state' or 'event'")
+        raise ValueError(f"Unknown storage type: {storage_type}. Use 'state', 'event', 'bitmap' or 'bitmap_rle'")
     
+    if rotation_weeks > 1:
+        # Rotation: 3-word header, one pattern reference per day, and in the worst case every
+        # day a distinct pattern (count word + events), plus the [0xFFFF, 0xFFFF] terminator
+        days = rotation_weeks * 7
+        return (3 + days + days + rotation_weeks * max_entries * multiplier + 2) * 2
+    
+    if second_resolution:
+        # Wide encoding: each event is a uint32_t (seconds-of-week + flags), single uint32_t terminator
+        return (max_entries * multiplier * 4) + 4
+    # Repeat windows (event-based): count word plus [index, span, interval] per window
+    repeat_bytes = (1 + repeat_windows * 3) * 2 if repeat_windows > 0 else 0
+    if compressed:
+        # One byte per event, a second byte for the few long gaps, plus the header and one escape
+        words = max_entries * multiplier
+        return (COMPRESSED_HEADER_BYTES + words + min(words, COMPRESSED_TWO_BYTE_TOKENS) +
+                COMPRESSED_ESCAPE_BYTES + repeat_bytes)
     # Each entry is multiplier * 2 bytes (uint16_t)
-    # Plus terminator is also multiplier * 2 bytes
-    return (max_entries * multiplier * 2) + (multiplier * 2)
+    # Plus the [0xFFFF, 0xFFFF] terminator (2 * uint16_t) used by both storage types
+    return (max_entries * multiplier * 2) + 4 + repeat_bytes
+
+# Storage header at the start of every schedule record: magic, version, layout, entry count,
+# payload bytes and CRC32 (must match sizeof(StorageHeader) in schedule_encoding.h)
+STORAGE_HEADER_BYTES = 12
+# Combined record header: magic (2 bytes), version, data sensor count
+COMBINED_HEADER_BYTES = 4
+
+def schedule_record_size(table_size, config, entries=None):
+    # Size of the schedule preference: the storage header, the table and, when combined, every data sensor column.
+    # Columns hold max_schedule_size entries unless another capacity (the size limit) is given.
+    if not config.get(CONF_COMBINED_STORAGE):
+        return STORAGE_HEADER_BYTES + table_size
+    entries = config[CONF_MAX_SCHEDULE_SIZE] if entries is None else entries
+    columns = sum(entries * ITEM_TYPE_BYTES[ITEM_TYPES[item[CONF_ITEM_TYPE]]]
+                  for item in config.get(CONF_SCHEDULED_DATA_ITEMS, []))
+    return STORAGE_HEADER_BYTES + COMBINED_HEADER_BYTES + table_size + columns
+
+# Runtime capacity: records start at max_schedule_size and grow, in chunks, up to schedule_size_limit
+# entries when Home Assistant sends a larger schedule. One C++ class serves every record size.
+SCHEDULE_SIZE_LIMIT_SCHEMA = {
+    cv.Optional(CONF_SCHEDULE_SIZE_LIMIT): cv.int_range(min=1, max=0xFFFF),
+}
+
+def validate_schedule_size_limit(config):
+    if CONF_SCHEDULE_SIZE_LIMIT not in config:
+        return config
+    if config[CONF_SCHEDULE_SIZE_LIMIT] < config[CONF_MAX_SCHEDULE_SIZE]:
+        raise cv.Invalid(f"{CONF_SCHEDULE_SIZE_LIMIT} cannot be less than {CONF_MAX_SCHEDULE_SIZE}")
+    # Rotation weeks share day patterns sized for max_schedule_size
+    if config[CONF_SCHEDULE_SIZE_LIMIT] > config[CONF_MAX_SCHEDULE_SIZE] and CONF_ROTATION_ENTITY_IDS in config:
+        raise cv.Invalid(f"{CONF_SCHEDULE_SIZE_LIMIT} above {CONF_MAX_SCHEDULE_SIZE} is not supported with "
+                         f"{CONF_ROTATION_ENTITY_IDS}")
+    return config
+
+def schedule_size_limit(config):
+    # Entries the schedule may grow to (max_schedule_size when no limit is configured).
+    return config.get(CONF_SCHEDULE_SIZE_LIMIT, config[CONF_MAX_SCHEDULE_SIZE])
+
+def new_array_preference(size, max_size):
+    # Preference record of size bytes that can grow to max_size at runtime.
+    return cg.RawExpression(f'new esphome::schedule::ArrayPreference({size}, {max_size})')
 
 ITEM_TYPES = {
     "uint8_t": 0,
@@ -102,11 +220,50 @@ def validate_manual_value(config):
             raise cv.Invalid(f"{CONF_MANUAL_VALUE} is required when {CONF_MANUAL_BEHAVIOR} is MANUAL_VALUE")
     return config
 
+# Ramp modes for data sensors: move from the previous ON value to the new one over a window
+DataSensorRampMode = schedule_ns.enum("DataSensorRampMode")
+RAMP_MODES = {
+    "LINEAR": DataSensorRampMode.DATA_SENSOR_RAMP_LINEAR,
+    "STEP": DataSensorRampMode.DATA_SENSOR_RAMP_STEP,
+}
+
+def validate_ramp(config):
+    # STEP ramps need a step size; the interval bounds how often a value is published.
+    if config[CONF_RAMP_MODE] == "STEP" and CONF_RAMP_STEP not in config:
+        raise cv.Invalid(f"{CONF_RAMP_STEP} is required when {CONF_RAMP_MODE} is STEP")
+    if config[CONF_RAMP_INTERVAL] > config[CONF_RAMP_DURATION]:
+        raise cv.Invalid(f"{CONF_RAMP_INTERVAL} must not be longer than {CONF_RAMP_DURATION}")
+    return config
+
+RAMP_SCHEMA = cv.All(
+    cv.Schema({
+        cv.Optional(CONF_RAMP_MODE, default="LINEAR"): cv.enum(RAMP_MODES, upper=True),
+        cv.Required(CONF_RAMP_DURATION): cv.All(cv.positive_time_period_seconds,
+                                                cv.Range(min=cv.TimePeriod(seconds=1))),
+        cv.Optional(CONF_RAMP_INTERVAL, default="60s"): cv.All(cv.positive_time_period_seconds,
+                                                               cv.Range(min=cv.TimePeriod(seconds=1))),
+        cv.Optional(CONF_RAMP_STEP): cv.positive_not_null_float,
+    }),
+    validate_ramp,
+)
+
+async def register_data_sensor_ramp(sens, config):
+    # Configure the optional ramp on a data sensor; steps are driven by the tick service timer wheel.
+    if CONF_RAMP not in config:
+        return
+    ramp = config[CONF_RAMP]
+    cg.add(sens.set_ramp_mode(ramp[CONF_RAMP_MODE]))
+    cg.add(sens.set_ramp_duration(ramp[CONF_RAMP_DURATION].total_seconds))
+    cg.add(sens.set_ramp_interval(ramp[CONF_RAMP_INTERVAL].total_seconds))
+    if CONF_RAMP_STEP in ramp:
+        cg.add(sens.set_ramp_step(ramp[CONF_RAMP_STEP]))
+
 # Base schema for data sensors (common to all schedule types)
 _DATA_SENSOR_BASE_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(DataSensor),
     cv.Required(CONF_ITEM_LABEL): cv.string,
     cv.Required(CONF_ITEM_TYPE): cv.enum(ITEM_TYPES, lower=True, space="_"),
+    cv.Optional(CONF_RAMP): RAMP_SCHEMA,
 }).extend(cv.COMPONENT_SCHEMA.extend({
     cv.Optional(CONF_ICON): cv.icon,
     cv.Optional(CONF_ENTITY_CATEGORY): cv.entity_category,
@@ -139,6 +296,209 @@ DATA_SENSOR_SCHEMA_EVENT_BASED = _DATA_SENSOR_BASE_SCHEMA.extend({
     cv.Optional(CONF_MANUAL_VALUE): cv.invalid("Manual value not applicable to event-based schedules"),
 })
 
+# Day exceptions: dates (MM-DD, any year) that run another weekday's pattern or stay off
+DayException = schedule_ns.enum("DayException")
+DAY_EXCEPTION_RUN_AS = {
+    "monday": DayException.DAY_EXCEPTION_AS_MONDAY,
+    "tuesday": DayException.DAY_EXCEPTION_AS_TUESDAY,
+    "wednesday": DayException.DAY_EXCEPTION_AS_WEDNESDAY,
+    "thursday": DayException.DAY_EXCEPTION_AS_THURSDAY,
+    "friday": DayException.DAY_EXCEPTION_AS_FRIDAY,
+    "saturday": DayException.DAY_EXCEPTION_AS_SATURDAY,
+    "sunday": DayException.DAY_EXCEPTION_AS_SUNDAY,
+    "off": DayException.DAY_EXCEPTION_OFF,
+}
+
+# Days per month in a leap year, so 02-29 is accepted
+_DAYS_IN_MONTH = [31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31]
+
+def validate_month_day(value):
+    # Validate a "MM-DD" date and return it as a (month, day) tuple.
+    value = cv.string_strict(value)
+    try:
+        month, day = (int(part) for part in value.split("-"))
+    except ValueError as err:
+        raise cv.Invalid(f"Date must be in MM-DD format, got '{value}'") from err
+    if not 1 <= month <= 12 or not 1 <= day <= _DAYS_IN_MONTH[month - 1]:
+        raise cv.Invalid(f"Invalid date '{value}'")
+    return (month, day)
+
+DAY_EXCEPTION_SCHEMA = cv.Schema({
+    cv.Required(CONF_DATE): validate_month_day,
+    cv.Optional(CONF_UNTIL): validate_month_day,
+    cv.Required(CONF_RUN_AS): cv.one_of(*DAY_EXCEPTION_RUN_AS, lower=True),
+})
+
+async def register_day_exceptions(var, config):
+    # Load the configured exception dates into the schedule's per-date overlay table.
+    for exception in config.get(CONF_DAY_EXCEPTIONS, []):
+        month, day = exception[CONF_DATE]
+        until_month, until_day = exception.get(CONF_UNTIL, exception[CONF_DATE])
+        run_as = DAY_EXCEPTION_RUN_AS[exception[CONF_RUN_AS]]
+        cg.add(var.add_day_exception(month, day, until_month, until_day, run_as))
+
+# Multi-week rotation: extra HA schedules, one per additional week, selected by the week counted from 1970-01-05
+ROTATION_SCHEMA = {
+    cv.Optional(CONF_ROTATION_ENTITY_IDS): cv.All(cv.ensure_list(cv.string), cv.Length(min=1, max=51)),
+    cv.Optional(CONF_ROTATION_WEEK_OFFSET, default=0): cv.int_range(min=0, max=52),
+}
+
+def validate_rotation(config):
+    # Rotation weeks share day patterns that only hold event times
+    if CONF_ROTATION_ENTITY_IDS not in config:
+        return config
+    if config.get(CONF_SCHEDULED_DATA_ITEMS):
+        raise cv.Invalid(f"{CONF_SCHEDULED_DATA_ITEMS} are not supported with {CONF_ROTATION_ENTITY_IDS}")
+    if config.get(CONF_SECOND_RESOLUTION):
+        raise cv.Invalid(f"{CONF_SECOND_RESOLUTION} is not supported with {CONF_ROTATION_ENTITY_IDS}")
+    return config
+
+def rotation_weeks(config):
+    # Number of weeks in the rotation (1 when no rotation is configured).
+    return 1 + len(config.get(CONF_ROTATION_ENTITY_IDS, []))
+
+async def register_rotation(var, config):
+    # Register the additional weeks of a multi-week rotation.
+    for entity_id in config.get(CONF_ROTATION_ENTITY_IDS, []):
+        cg.add(var.add_rotation_entity_id(entity_id))
+    if CONF_ROTATION_ENTITY_IDS in config:
+        cg.add(var.set_rotation_week_offset(config[CONF_ROTATION_WEEK_OFFSET]))
+
+# Sunrise/sunset-relative entries: the location used to compute the shared solar table
+SOLAR_SCHEMA = {
+    cv.Optional(CONF_LATITUDE): cv.latitude,
+    cv.Optional(CONF_LONGITUDE): cv.longitude,
+}
+
+# Options whose tables the compressed format cannot hold (it stores plain minute tables only)
+_COMPRESSED_STORAGE_CONFLICTS = (CONF_SECOND_RESOLUTION, CONF_ROTATION_ENTITY_IDS, CONF_LATITUDE)
+
+def compressed_storage_supported(config):
+    return not any(config.get(option) for option in _COMPRESSED_STORAGE_CONFLICTS)
+
+def validate_compressed_storage(config):
+    if not config.get(CONF_COMPRESSED_STORAGE):
+        return config
+    for option in _COMPRESSED_STORAGE_CONFLICTS:
+        if config.get(option):
+            raise cv.Invalid(f"{CONF_COMPRESSED_STORAGE} is not supported with {option}")
+    return config
+
+def report_schedule_storage(config, raw_size, compressed_size):
+    # Log both sizes so the saving is visible when choosing max_schedule_size.
+    _LOGGER.info("Schedule '%s': %u bytes raw, %u bytes compressed (worst case)%s",
+                 config[CONF_HA_SCHEDULE_ENTITY_ID], raw_size, compressed_size,
+                 " - using compressed" if config.get(CONF_COMPRESSED_STORAGE) else "")
+
+def validate_solar(config):
+    # Solar times are stored in the plain minute table, resolved once per day
+    if (CONF_LATITUDE in config) != (CONF_LONGITUDE in config):
+        raise cv.Invalid(f"{CONF_LATITUDE} and {CONF_LONGITUDE} must be set together")
+    if CONF_LATITUDE not in config:
+        return config
+    if config.get(CONF_SECOND_RESOLUTION):
+        raise cv.Invalid(f"Solar times are not supported with {CONF_SECOND_RESOLUTION}")
+    if CONF_ROTATION_ENTITY_IDS in config:
+        raise cv.Invalid(f"Solar times are not supported with {CONF_ROTATION_ENTITY_IDS}")
+    return config
+
+async def register_solar(var, config):
+    # Attach the solar table for the configured location, shared by all schedules at that location.
+    if CONF_LATITUDE not in config:
+        return
+    tables = CORE.data.setdefault(KEY_SCHEDULE, {}).setdefault(KEY_SOLAR_TABLES, {})
+    location = (config[CONF_LATITUDE], config[CONF_LONGITUDE])
+    table = tables.get(location)
+    if table is None:
+        table = cg.new_Pvariable(ID(f"schedule_solar_table_{len(tables)}", is_declaration=True, type=SolarTable),
+                                 *location)
+        tables[location] = table
+    cg.add(var.set_solar_table(table))
+
+# on_before_event: fire a fixed lead time before the next event (state-based schedules may pick ON or OFF)
+LeadTriggerFilter = schedule_ns.enum("LeadTriggerFilter")
+LEAD_TRIGGER_FILTERS = {
+    "ANY": LeadTriggerFilter.LEAD_TRIGGER_ANY,
+    "ON": LeadTriggerFilter.LEAD_TRIGGER_ON,
+    "OFF": LeadTriggerFilter.LEAD_TRIGGER_OFF,
+}
+
+_LEAD_TRIGGER_BASE_SCHEMA = cv.Schema({
+    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ScheduleLeadTrigger),
+    cv.Required(CONF_LEAD): cv.All(cv.positive_time_period_seconds, cv.Range(min=cv.TimePeriod(seconds=1))),
+})
+
+LEAD_TRIGGER_SCHEMA_STATE_BASED = cv.Schema({
+    cv.Optional(CONF_ON_BEFORE_EVENT): automation.validate_automation(_LEAD_TRIGGER_BASE_SCHEMA.extend({
+        cv.Optional(CONF_EVENT, default="ANY"): cv.enum(LEAD_TRIGGER_FILTERS, upper=True),
+    })),
+})
+
+LEAD_TRIGGER_SCHEMA_EVENT_BASED = cv.Schema({
+    cv.Optional(CONF_ON_BEFORE_EVENT): automation.validate_automation(_LEAD_TRIGGER_BASE_SCHEMA),
+})
+
+async def register_lead_triggers(var, config):
+    # Create the on_before_event triggers; each registers itself with the schedule.
+    for conf in config.get(CONF_ON_BEFORE_EVENT, []):
+        event_filter = conf.get(CONF_EVENT, "ANY")
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var, conf[CONF_LEAD].total_seconds,
+                                   LEAD_TRIGGER_FILTERS[event_filter])
+        await automation.build_automation(trigger, [], conf)
+
+# Deferred preference sync: saves mark records dirty and the tick service syncs them together.
+# The service is shared, so with several schedules the shortest configured delays apply.
+PREFERENCE_SYNC_SCHEMA = cv.Schema({
+    cv.Optional(CONF_PREFERENCE_SYNC_DELAY, default="1s"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_PREFERENCE_SYNC_MAX_DELAY, default="10s"): cv.All(
+        cv.positive_time_period_milliseconds, cv.Range(max=cv.TimePeriod(minutes=10))),
+})
+
+# Diagnostic counters of flash writes made and skipped as unchanged (schedule and data sensor records)
+_PREFERENCE_WRITE_SENSOR = cv.maybe_simple_value(
+    sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    key=CONF_NAME,
+)
+
+PREFERENCE_WRITES_SCHEMA = cv.Schema({
+    cv.Optional(CONF_PREFERENCE_WRITES): _PREFERENCE_WRITE_SENSOR,
+    cv.Optional(CONF_PREFERENCE_WRITES_SKIPPED): _PREFERENCE_WRITE_SENSOR,
+})
+
+async def register_preference_write_sensors(var, config):
+    # Create the optional write counter sensors; the schedule publishes them after each save.
+    if CONF_PREFERENCE_WRITES in config:
+        writes_var = await sensor.new_sensor(config[CONF_PREFERENCE_WRITES])
+        cg.add(var.set_pref_writes_sensor(writes_var))
+    if CONF_PREFERENCE_WRITES_SKIPPED in config:
+        skipped_var = await sensor.new_sensor(config[CONF_PREFERENCE_WRITES_SKIPPED])
+        cg.add(var.set_pref_writes_skipped_sensor(skipped_var))
+
+def validate_preference_sync(config):
+    if config[CONF_PREFERENCE_SYNC_DELAY] > config[CONF_PREFERENCE_SYNC_MAX_DELAY]:
+        raise cv.Invalid(f"{CONF_PREFERENCE_SYNC_DELAY} must not exceed {CONF_PREFERENCE_SYNC_MAX_DELAY}")
+    return config
+
+async def register_schedule_tick(var, config):
+    # Register a schedule with the device-wide tick service, creating the service on first use.
+    # The service captures one time/connection snapshot per tick and fans it out to all schedules,
+    # and batches the preference syncs of every schedule.
+    data = CORE.data.setdefault(KEY_SCHEDULE, {})
+    service = data.get(KEY_TICK_SERVICE)
+    if service is None:
+        service = cg.new_Pvariable(ID("schedule_tick_service", is_declaration=True, type=ScheduleTickService))
+        cg.add(cg.App.register_component(service))
+        time_var = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(service.set_time(time_var))
+        data[KEY_TICK_SERVICE] = service
+    cg.add(service.register_schedule(var))
+    cg.add(service.limit_sync_delay(config[CONF_PREFERENCE_SYNC_DELAY].total_milliseconds,
+                                    config[CONF_PREFERENCE_SYNC_MAX_DELAY].total_milliseconds))
+
 # Empty schema - schedule is a base library component, platforms extend it
 CONFIG_SCHEMA = cv.Schema({})
 
@@ -2,9 +2,22 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/preferences.h"
+#include "schedule_tick_service.h"
+#include <algorithm>
+#include <vector>
 
 namespace esphome {
 namespace schedule {
+
+/** Preference object with byte-level load and save, for records whose size is only known at runtime */
+class RawPreferenceObject : public ESPPreferenceObject {
+ public:
+  RawPreferenceObject() = default;
+  explicit RawPreferenceObject(const ESPPreferenceObject &object) : ESPPreferenceObject(object) {}
+  bool load(uint8_t *data, size_t size) { return this->backend_ != nullptr && this->backend_->load(data, size); }
+  bool save(const uint8_t *data, size_t size) { return this->backend_ != nullptr && this->backend_->save(data, size); }
+};
+
 class ArrayPreferenceBase : public Component {
  public:
   virtual void create_preference(uint32_t key) = 0;
@@ -13,42 +26,201 @@ class ArrayPreferenceBase : public Component {
   virtual uint8_t *data() = 0;
   virtual size_t size() const = 0;
   virtual bool is_valid() const = 0;
+  /** Change the record size at runtime (up to max_size()); content up to the smaller size is kept */
+  virtual bool resize(size_t size) = 0;
+  virtual size_t max_size() const = 0;
+
+  /** Records are stored as chunks of this size, one preference each: chunk 0 under the record key,
+   * the last one only as long as the record needs. A record up to one chunk is a single plain blob.
+   */
+  static constexpr size_t CHUNK_BYTES = 256;
+  static uint32_t chunk_key(uint32_t key, size_t index) {
+    return index == 0 ? key : key ^ (static_cast<uint32_t>(index) * 0x9E3779B9UL);
+  }
+  static size_t chunk_count(size_t size) { return (size + CHUNK_BYTES - 1) / CHUNK_BYTES; }
+  /** Add one chunk of capacity; false once max_size() is reached */
+  bool grow() {
+    return this->size() < this->max_size() && this->resize(std::min(this->size() + CHUNK_BYTES, this->max_size()));
+  }
 
   void setup() override {}
   void loop() override {}
+
+  /** Saves that reached flash, and saves skipped because the content was already stored */
+  uint32_t get_write_count() const { return this->write_count_; }
+  uint32_t get_skipped_write_count() const { return this->skipped_write_count_; }
+
+  /** Defer the flash sync to the tick service, which coalesces it with other dirty records.
+   * Without a service every save syncs immediately.
+   */
+  void set_sync_service(ScheduleTickService *service) { this->sync_service_ = service; }
+  /** Saved but not yet synced to flash */
+  bool is_dirty() const { return this->dirty_; }
+  void mark_synced() { this->dirty_ = false; }
+
+  /** A/B slots: each record has two keys. Loads read the committed slot and an update writes the
+   * other one, which only becomes committed once the schedule's slot pointer naming it is on flash.
+   * Slot 0 keeps the original key, so records saved before slots existed load as slot 0.
+   */
+  static constexpr uint32_t SLOT_B_KEY_SALT = 0x5B5B5B5B;
+  static uint32_t slot_key(uint32_t key, uint8_t slot) { return slot == 0 ? key : key ^ SLOT_B_KEY_SALT; }
+  /** Set before create_preference() from the slot pointer loaded at boot */
+  void set_committed_slot(uint8_t slot) {
+    this->committed_slot_ = slot;
+    this->slot_ = slot;
+  }
+  uint8_t get_slot() const { return this->slot_; }
+  /** Buffer content equals the committed slot, so an update has nothing to write */
+  bool matches_committed() {
+    return this->slot_ == this->committed_slot_ && this->stored_hash_known_ &&
+           content_hash_(this->data(), this->size()) == this->stored_hash_;
+  }
+  /** Direct the next save to the slot not holding the committed generation (kept while one is open) */
+  void begin_update() {
+    if (this->slot_ != this->committed_slot_) {
+      return;
+    }
+    this->slot_ ^= 1;
+    this->stored_hash_known_ = false;  // Whatever the other slot holds is an older generation
+  }
+  /** The slot written by the update is now the committed one */
+  void commit_slot() { this->committed_slot_ = this->slot_; }
+
+  /** Read the record as it was saved with a different size (e.g. before max_schedule_size changed).
+   * Records written before the chunked store are one blob of stored_size bytes.
+   */
+  bool load_resized(size_t stored_size, std::vector<uint8_t> &out, bool chunked) {
+    if (stored_size == 0) {
+      return false;
+    }
+    uint32_t key = slot_key(this->key_, this->slot_);
+    out.assign(stored_size, 0);
+    size_t chunk_size = chunked ? CHUNK_BYTES : stored_size;
+    for (size_t offset = 0, index = 0; offset < stored_size; offset += chunk_size, index++) {
+      size_t length = std::min(chunk_size, stored_size - offset);
+      RawPreferenceObject chunk(global_preferences->make_preference(length, chunk_key(key, index)));
+      if (!chunk.load(out.data() + offset, length)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ protected:
+  void commit_() {
+    if (this->sync_service_ == nullptr) {
+      global_preferences->sync();
+      return;
+    }
+    this->dirty_ = true;
+    this->sync_service_->request_pref_sync(this);
+  }
+
+  /** FNV-1a over the buffer; compared against the last loaded/saved content before writing */
+  static uint32_t content_hash_(const uint8_t *data, size_t size) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= data[i];
+      hash *= 16777619UL;
+    }
+    return hash;
+  }
+
+  uint32_t stored_hash_{0};
+  bool stored_hash_known_{false};  // stored_hash_ matches the record on flash
+  uint32_t write_count_{0};
+  uint32_t skipped_write_count_{0};
+  ScheduleTickService *sync_service_{nullptr};
+  bool dirty_{false};
+  uint32_t key_{0};
+  uint8_t slot_{0};            // Slot that loads and saves use
+  uint8_t committed_slot_{0};  // Slot named by the slot pointer
 };
 
-template<size_t N>
+/**
+ * ArrayPreference - runtime-sized preference record stored as CHUNK_BYTES chunks
+ *
+ * The size is a constructor argument rather than a template parameter, so every record
+ * shares one class, and a record can grow at runtime up to max_size (e.g. when Home
+ * Assistant sends a larger schedule) without a firmware rebuild.
+ */
 class ArrayPreference : public ArrayPreferenceBase {
  public:
-  ArrayPreference() { memset(data_, 0, N); }
+  ArrayPreference(size_t size, size_t max_size) : data_(size, 0), max_size_(std::max(size, max_size)) {}
 
-  void create_preference(uint32_t key) override {
-    pref_ = global_preferences->make_preference<uint8_t[N]>(key);
-  }
+  void create_preference(uint32_t key) override { this->key_ = key; }
 
   void load() override {
-    uint8_t buf[N];
-    valid_ = pref_.load(&buf);
+    // Chunks are read into a scratch copy so a partial load leaves the buffer untouched
+    std::vector<uint8_t> buf(this->data_.size());
+    valid_ = true;
+    for (size_t index = 0; index < chunk_count(buf.size()) && valid_; index++) {
+      size_t offset = index * CHUNK_BYTES;
+      valid_ = this->chunk_(index).load(buf.data() + offset, std::min(CHUNK_BYTES, buf.size() - offset));
+    }
     if (valid_) {
-        memcpy(data_, buf, N);
+      this->data_ = std::move(buf);
+      this->stored_hash_ = content_hash_(this->data_.data(), this->data_.size());
+      this->stored_hash_known_ = true;
     } else {
-        ESP_LOGW("ArrayPreference", "Failed to load preference");
+      ESP_LOGW("ArrayPreference", "Failed to load preference");
     }
   }
 
   void save() override {
-    pref_.save(&data_);
-    global_preferences->sync();
+    // Identical content (e.g. a schedule re-fetched on reconnect) costs no flash write or sync
+    uint32_t hash = content_hash_(this->data_.data(), this->data_.size());
+    if (this->stored_hash_known_ && hash == this->stored_hash_) {
+      this->skipped_write_count_++;
+      ESP_LOGV("ArrayPreference", "Content unchanged, skipping write");
+      return;
+    }
+    for (size_t index = 0; index < chunk_count(this->data_.size()); index++) {
+      size_t offset = index * CHUNK_BYTES;
+      this->chunk_(index).save(this->data_.data() + offset, std::min(CHUNK_BYTES, this->data_.size() - offset));
+    }
+    this->commit_();
+    this->stored_hash_ = hash;
+    this->stored_hash_known_ = true;
+    this->write_count_++;
   }
 
-  uint8_t *data() override { return data_; }
-  size_t size() const override { return N; }
+  uint8_t *data() override { return this->data_.data(); }
+  size_t size() const override { return this->data_.size(); }
   bool is_valid() const override { return valid_; }
 
+  bool resize(size_t size) override {
+    if (size > this->max_size_) {
+      return false;
+    }
+    if (size != this->data_.size()) {
+      this->data_.resize(size, 0);
+      // Chunk lengths change with the size, so the next save writes every chunk
+      this->stored_hash_known_ = false;
+      for (auto &chunks : this->chunks_) {
+        chunks.clear();
+      }
+    }
+    return true;
+  }
+  size_t max_size() const override { return this->max_size_; }
+
  private:
-  uint8_t data_[N];
-  ESPPreferenceObject pref_;
+  /** Preference object of a chunk in the open slot, created on first use and reused after */
+  RawPreferenceObject &chunk_(size_t index) {
+    auto &chunks = this->chunks_[this->slot_];
+    while (chunks.size() <= index) {
+      size_t offset = chunks.size() * CHUNK_BYTES;
+      size_t length = std::min(CHUNK_BYTES, this->data_.size() - offset);
+      chunks.emplace_back(global_preferences->make_preference(length, chunk_key(slot_key(this->key_, this->slot_),
+                                                                                  chunks.size())));
+    }
+    return chunks[index];
+  }
+
+  std::vector<uint8_t> data_;
+  size_t max_size_;
+  std::vector<RawPreferenceObject> chunks_[2];  // A/B slots
   bool valid_ = false;
 };
 }   // namespace schedule
@@ -13,6 +13,8 @@ from esphome.const import (
     CONF_ENTITY_CATEGORY,
     CONF_TIME_ID,
     ENTITY_CATEGORY_CONFIG,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_TOTAL_INCREASING,
 )
 
 # Import from parent __init__.py
@@ -29,6 +31,36 @@ from .. import (
     ITEM_TYPES,
     ITEM_TYPE_BYTES,
     calculate_schedule_array_size,
+    register_schedule_tick,
+    register_day_exceptions,
+    CONF_SECOND_RESOLUTION,
+    CONF_COMBINED_STORAGE,
+    CONF_COMPRESSED_STORAGE,
+    validate_compressed_storage,
+    compressed_storage_supported,
+    report_schedule_storage,
+    schedule_record_size,
+    CONF_SCHEDULE_SIZE_LIMIT,
+    SCHEDULE_SIZE_LIMIT_SCHEMA,
+    validate_schedule_size_limit,
+    schedule_size_limit,
+    new_array_preference,
+    CONF_DAY_EXCEPTIONS,
+    DAY_EXCEPTION_SCHEMA,
+    ROTATION_SCHEMA,
+    validate_rotation,
+    rotation_weeks,
+    register_rotation,
+    SOLAR_SCHEMA,
+    validate_solar,
+    register_solar,
+    register_data_sensor_ramp,
+    LEAD_TRIGGER_SCHEMA_EVENT_BASED,
+    PREFERENCE_SYNC_SCHEMA,
+    PREFERENCE_WRITES_SCHEMA,
+    register_preference_write_sensors,
+    validate_preference_sync,
+    register_lead_triggers,
 )
 
 CODEOWNERS = ["@pebblebed-tech"]
@@ -41,12 +73,72 @@ CONF_CURRENT_EVENT = "current_event"
 CONF_NEXT_EVENT = "next_event"
 CONF_MODE_SELECT = "mode_selector"
 CONF_UPDATE_ON_RECONNECT = "update_schedule_from_ha_on_reconnect"
+CONF_CATCH_UP_POLICY = "catch_up_policy"
+CONF_CATCH_UP_MAX_EVENTS = "catch_up_max_events"
+CONF_SKIPPED_EVENTS = "skipped_events"
+CONF_RECURRENCE_RULES = "recurrence_rules"
+CONF_EVERY = "every"
+CONF_FROM = "from"
+CONF_TO = "to"
+CONF_DAYS = "days"
+CONF_MAX_REPEAT_WINDOWS = "max_repeat_windows"
 
 # C++ classes
 ScheduleButton = schedule_ns.class_("ScheduleButton", esphome_button.Button, EventBasedSchedulable)
 UpdateScheduleButton = schedule_ns.class_("UpdateScheduleButton", button.Button, cg.Component)
 ScheduleEventModeSelect = schedule_ns.class_("ScheduleEventModeSelect", select.Select, cg.Component)
 
+# What to do with events skipped by a forward clock jump
+CatchUpPolicy = schedule_ns.enum("CatchUpPolicy")
+CATCH_UP_POLICIES = {
+    "skip": CatchUpPolicy.CATCH_UP_SKIP,
+    "last": CatchUpPolicy.CATCH_UP_LAST,
+    "replay": CatchUpPolicy.CATCH_UP_REPLAY,
+}
+
+# Recurrence rule days: bit 0 = Monday, matching the schedule's day order
+RULE_DAYS = {"mon": 0, "tue": 1, "wed": 2, "thu": 3, "fri": 4, "sat": 5, "sun": 6}
+RULE_DAY_GROUPS = {"daily": 0x7F, "weekdays": 0x1F, "weekends": 0x60}
+
+def validate_rule_days(value):
+    # Convert a list of day names / groups into the rule's day bit mask.
+    mask = 0
+    for day in cv.ensure_list(cv.string_strict)(value):
+        day = day.lower()
+        if day in RULE_DAY_GROUPS:
+            mask |= RULE_DAY_GROUPS[day]
+        elif day[:3] in RULE_DAYS:
+            mask |= 1 << RULE_DAYS[day[:3]]
+        else:
+            raise cv.Invalid(f"Unknown day '{day}', expected mon..sun, weekdays, weekends or daily")
+    if mask == 0:
+        raise cv.Invalid("At least one day is required")
+    return mask
+
+def validate_minute_of_day(value):
+    # Validate an "HH:MM" time and return it as minutes after midnight.
+    value = cv.string_strict(value)
+    try:
+        hour, minute = (int(part) for part in value.split(":"))
+    except ValueError as err:
+        raise cv.Invalid(f"Time must be in HH:MM format, got '{value}'") from err
+    if not 0 <= hour <= 23 or not 0 <= minute <= 59:
+        raise cv.Invalid(f"Invalid time '{value}'")
+    return hour * 60 + minute
+
+def validate_recurrence_rule(config):
+    if config[CONF_FROM] > config[CONF_TO]:
+        raise cv.Invalid(f"'{CONF_FROM}' must not be after '{CONF_TO}'")
+    return config
+
+RECURRENCE_RULE_SCHEMA = cv.All(cv.Schema({
+    cv.Required(CONF_EVERY): cv.All(cv.positive_time_period_minutes,
+                                    cv.Range(min=cv.TimePeriod(minutes=1), max=cv.TimePeriod(minutes=1440))),
+    cv.Optional(CONF_FROM, default="00:00"): validate_minute_of_day,
+    cv.Optional(CONF_TO, default="23:59"): validate_minute_of_day,
+    cv.Optional(CONF_DAYS, default="daily"): validate_rule_days,
+}), validate_recurrence_rule)
+
 # Simplified mode options for event-based components (no state to maintain)
 SCHEDULE_BUTTON_MODE_OPTIONS = [
     "Disabled",
@@ -59,6 +151,7 @@ CONFIG_SCHEMA = esphome_button.button_schema(
     cv.GenerateID(): cv.declare_id(ScheduleButton),
     cv.Required(CONF_HA_SCHEDULE_ENTITY_ID): cv.string,
     cv.Optional(CONF_MAX_SCHEDULE_SIZE, default=21): cv.int_,
+    **SCHEDULE_SIZE_LIMIT_SCHEMA,
     cv.Optional(CONF_SCHEDULED_DATA_ITEMS): cv.ensure_list(DATA_SENSOR_SCHEMA_EVENT_BASED),
     cv.Required(CONF_UPDATE_BUTTON): cv.maybe_simple_value(
         button.button_schema(
@@ -86,7 +179,38 @@ CONFIG_SCHEMA = esphome_button.button_schema(
         cv.requires_component("time"), cv.use_id(time.RealTimeClock)
     ),
     cv.Optional(CONF_UPDATE_ON_RECONNECT, default=False): cv.boolean,
-}).extend(cv.COMPONENT_SCHEMA)
+    cv.Optional(CONF_SECOND_RESOLUTION, default=False): cv.boolean,
+    cv.Optional(CONF_COMBINED_STORAGE, default=False): cv.boolean,
+    cv.Optional(CONF_COMPRESSED_STORAGE, default=False): cv.boolean,
+    cv.Optional(CONF_DAY_EXCEPTIONS): cv.ensure_list(DAY_EXCEPTION_SCHEMA),
+    cv.Optional(CONF_RECURRENCE_RULES): cv.ensure_list(RECURRENCE_RULE_SCHEMA),
+    cv.Optional(CONF_MAX_REPEAT_WINDOWS, default=0): cv.int_range(min=0, max=500),
+    cv.Optional(CONF_CATCH_UP_POLICY, default="last"): cv.enum(CATCH_UP_POLICIES, lower=True),
+    cv.Optional(CONF_CATCH_UP_MAX_EVENTS, default=5): cv.int_range(min=1, max=1000),
+    cv.Optional(CONF_SKIPPED_EVENTS): cv.maybe_simple_value(
+        sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        key=CONF_NAME,
+    ),
+}).extend(ROTATION_SCHEMA).extend(SOLAR_SCHEMA).extend(LEAD_TRIGGER_SCHEMA_EVENT_BASED).extend(PREFERENCE_SYNC_SCHEMA).extend(PREFERENCE_WRITES_SCHEMA).extend(cv.COMPONENT_SCHEMA)
+
+def validate_repeat_windows(config):
+    # Repeat windows are stored after the plain minute table only
+    if config[CONF_MAX_REPEAT_WINDOWS] == 0:
+        return config
+    if config[CONF_SECOND_RESOLUTION]:
+        raise cv.Invalid(f"{CONF_MAX_REPEAT_WINDOWS} is not supported with {CONF_SECOND_RESOLUTION}")
+    if rotation_weeks(config) > 1:
+        raise cv.Invalid(f"{CONF_MAX_REPEAT_WINDOWS} is not supported with rotation schedules")
+    if config[CONF_MAX_REPEAT_WINDOWS] > config[CONF_MAX_SCHEDULE_SIZE]:
+        raise cv.Invalid(f"{CONF_MAX_REPEAT_WINDOWS} cannot exceed {CONF_MAX_SCHEDULE_SIZE}")
+    return config
+
+CONFIG_SCHEMA = cv.All(CONFIG_SCHEMA, validate_rotation, validate_repeat_windows, validate_solar, validate_compressed_storage,
+                       validate_preference_sync, validate_schedule_size_limit)
 
 async def to_code(config):
     # Create the button (which extends EventBasedSchedulable)
@@ -96,11 +220,45 @@ async def to_code(config):
     # Set up base Schedule properties
     cg.add(var.set_schedule_entity_id(config[CONF_HA_SCHEDULE_ENTITY_ID]))
     cg.add(var.set_max_schedule_entries(config[CONF_MAX_SCHEDULE_SIZE]))
+    cg.add(var.set_schedule_size_limit(schedule_size_limit(config)))
+    cg.add(var.set_second_resolution(config[CONF_SECOND_RESOLUTION]))
+    cg.add(var.set_catch_up_policy(config[CONF_CATCH_UP_POLICY]))
+    cg.add(var.set_catch_up_max_events(config[CONF_CATCH_UP_MAX_EVENTS]))
+    await register_rotation(var, config)
+    await register_solar(var, config)
+    await register_lead_triggers(var, config)
+    await register_preference_write_sensors(var, config)
+    
+    cg.add(var.set_max_repeat_windows(config[CONF_MAX_REPEAT_WINDOWS]))
+    
+    # Generated events on top of the HA schedule, computed on device rather than stored
+    for rule in config.get(CONF_RECURRENCE_RULES, []):
+        cg.add(var.add_recurrence_rule(rule[CONF_DAYS], rule[CONF_FROM], rule[CONF_TO],
+                                       rule[CONF_EVERY].total_minutes))
     
     # Calculate and create array preference for schedule times
     # ScheduleButton is event-based (stores EVENT times only, not ON/OFF pairs)
-    size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], 'event')
-    array_pref = cg.RawExpression(f'new esphome::schedule::ArrayPreference<{size}>()')
+    size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], 'event', config[CONF_SECOND_RESOLUTION],
+                                         rotation_weeks(config), config[CONF_MAX_REPEAT_WINDOWS])
+    if compressed_storage_supported(config):
+        compressed_size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], 'event',
+                                                        repeat_windows=config[CONF_MAX_REPEAT_WINDOWS], compressed=True)
+        report_schedule_storage(config, size, compressed_size)
+        if config[CONF_COMPRESSED_STORAGE]:
+            size = compressed_size
+    cg.add(var.set_compressed_storage(config[CONF_COMPRESSED_STORAGE]))
+    # Storage header, and with combined storage the data sensor columns, share this record
+    size = schedule_record_size(size, config)
+    # The record can grow at runtime to the size needed for schedule_size_limit entries
+    limit = schedule_size_limit(config)
+    limit_size = calculate_schedule_array_size(limit, 'event', config[CONF_SECOND_RESOLUTION], rotation_weeks(config),
+                                               config[CONF_MAX_REPEAT_WINDOWS])
+    if config[CONF_COMPRESSED_STORAGE]:
+        limit_size = calculate_schedule_array_size(limit, 'event', repeat_windows=config[CONF_MAX_REPEAT_WINDOWS],
+                                                   compressed=True)
+    limit_size = schedule_record_size(limit_size, config, limit)
+    cg.add(var.set_combined_storage(config[CONF_COMBINED_STORAGE]))
+    array_pref = new_array_preference(size, limit_size)
     cg.add(var.sched_add_pref(array_pref))
     
     # Set internal to true by default
@@ -121,6 +279,11 @@ async def to_code(config):
         next_event_var = await text_sensor.new_text_sensor(config[CONF_NEXT_EVENT])
         cg.add(var.set_next_event_sensor(next_event_var))
     
+    # Create skipped events counter if configured
+    if CONF_SKIPPED_EVENTS in config:
+        skipped_var = await sensor.new_sensor(config[CONF_SKIPPED_EVENTS])
+        cg.add(var.set_skipped_events_sensor(skipped_var))
+    
     # Create mode_select (required)
     mode_select_var = await select.new_select(config[CONF_MODE_SELECT], options=SCHEDULE_BUTTON_MODE_OPTIONS)
     await cg.register_component(mode_select_var, config[CONF_MODE_SELECT])
@@ -131,6 +294,12 @@ async def to_code(config):
     time_var = await cg.get_variable(config[CONF_TIME_ID])
     cg.add(var.set_time(time_var))
     
+    # Drive the schedule from the shared device-wide tick
+    await register_schedule_tick(var, config)
+    
+    # Holiday / shutdown overrides on top of the weekly schedule
+    await register_day_exceptions(var, config)
+    
     # Set update on reconnect flag
     if config[CONF_UPDATE_ON_RECONNECT]:
         cg.add(var.set_update_on_reconnect(True))
@@ -145,7 +314,7 @@ async def to_code(config):
             max_entries = config[CONF_MAX_SCHEDULE_SIZE]
             item_type_bytes = ITEM_TYPE_BYTES[item_type]
             sensor_array_size = max_entries * item_type_bytes
-            sensor_array_pref = cg.RawExpression(f'new esphome::schedule::ArrayPreference<{sensor_array_size}>()')
+            sensor_array_pref = new_array_preference(sensor_array_size, schedule_size_limit(config) * item_type_bytes)
             
             sens = cg.new_Pvariable(sensor_config[CONF_ID])
             await sensor.register_sensor(sens, sensor_config)
@@ -154,7 +323,9 @@ async def to_code(config):
             cg.add(sens.set_label(label))
             cg.add(sens.set_item_type(item_type))
             cg.add(sens.set_max_schedule_data_entries(max_entries))
-            cg.add(sens.set_array_preference(sensor_array_pref))
+            if not config[CONF_COMBINED_STORAGE]:
+                cg.add(sens.set_array_preference(sensor_array_pref))
+            await register_data_sensor_ramp(sens, sensor_config)
             
             # Event-based schedules don't have OFF or Manual states
             # So we don't set off_behavior, off_value, manual_behavior, or manual_value
@@ -11,6 +11,7 @@ void ScheduleButton::dump_config() {
   LOG_BUTTON("", "Schedule Button", this);
   // Call base schedule configuration
   this->dump_config_base();
+  this->dump_config_event_based_();
 }
 
 // Note: setup() is defined inline in the header
@@ -16,11 +16,24 @@ void DataSensor::setup() {
     return;
   }
   
+  // Combined storage: only the local vector; the parent schedule fills it from its record
+  if (this->combined_storage_) {
+    this->total_bytes_ = this->max_schedule_data_entries_ * this->get_bytes_for_type(this->item_type_);
+    this->data_vector_.assign(this->total_bytes_, 0);
+    ESP_LOGI(TAG_DATA_SENSOR, "DataSensor '%s' setup complete: %u bytes in the schedule record",
+             this->get_label().c_str(), static_cast<unsigned>(this->data_vector_.size()));
+    return;
+  }
+  
   // Ensure array_pref_ is set
   if (this->array_pref_ == nullptr) {
     ESP_LOGE(TAG_DATA_SENSOR, "array_pref not set for sensor '%s'", this->get_label().c_str());
     return;
   }
+  // Saves are synced to flash together with the schedule's by the tick service
+  if (this->parent_schedule_ != nullptr) {
+    this->array_pref_->set_sync_service(this->parent_schedule_->get_tick_service());
+  }
   
   // Calculate bytes needed and resize local vector
   this->total_bytes_ = this->max_schedule_data_entries_ * this->get_bytes_for_type(this->item_type_);
@@ -62,6 +75,13 @@ void DataSensor::dump_config() {
   if (this->manual_behavior_ == DATA_SENSOR_MANUAL_BEHAVIOR_MANUAL_VALUE) {
     ESP_LOGCONFIG(TAG_DATA_SENSOR, "  Manual Value: %.2f", this->manual_value_);
   }
+  if (this->ramp_mode_ != DATA_SENSOR_RAMP_NONE) {
+    ESP_LOGCONFIG(TAG_DATA_SENSOR, "  Ramp: %s over %us (updates at most every %us)", this->get_ramp_mode_string(),
+                  static_cast<unsigned>(this->ramp_duration_s_), static_cast<unsigned>(this->ramp_interval_s_));
+    if (this->ramp_mode_ == DATA_SENSOR_RAMP_STEP) {
+      ESP_LOGCONFIG(TAG_DATA_SENSOR, "  Ramp Step: %.2f", this->ramp_step_);
+    }
+  }
 }
 
 const char* DataSensor::get_off_behavior_string() const {
@@ -88,7 +108,20 @@ const char* DataSensor::get_manual_behavior_string() const {
   }
 }
 
+const char* DataSensor::get_ramp_mode_string() const {
+  switch (this->ramp_mode_) {
+    case DATA_SENSOR_RAMP_LINEAR:
+      return "LINEAR";
+    case DATA_SENSOR_RAMP_STEP:
+      return "STEP";
+    case DATA_SENSOR_RAMP_NONE:
+    default:
+      return "NONE";
+  }
+}
+
 void DataSensor::apply_off_behavior(const char* context) {
+  this->cancel_ramp_();
   switch (this->off_behavior_) {
     case DATA_SENSOR_OFF_BEHAVIOR_LAST_ON_VALUE:
       if (!std::isnan(this->last_on_value_)) {
@@ -117,6 +150,7 @@ void DataSensor::apply_off_behavior(const char* context) {
 }
 
 void DataSensor::apply_manual_behavior() {
+  this->cancel_ramp_();
   switch (this->manual_behavior_) {
     case DATA_SENSOR_MANUAL_BEHAVIOR_LAST_ON_VALUE:
       if (!std::isnan(this->last_on_value_)) {
@@ -175,7 +209,14 @@ void DataSensor::apply_state(int16_t event_index, bool switch_state, bool manual
     ESP_LOGV(TAG_DATA_SENSOR, "Sensor '%s': event_index=%d, data_index=%d", 
              this->get_name().c_str(), event_index, data_index);
     
-    this->get_and_publish_sensor_value(data_index);
+    // The type switch runs once per event; ramp steps only add the precomputed increment
+    float value = this->get_sensor_value(data_index);
+    if (this->start_ramp_(value)) {
+      return;
+    }
+    this->publish_state(value);
+    ESP_LOGD(TAG_DATA_SENSOR, "Published value %.2f from index %u for sensor '%s'", 
+             value, static_cast<unsigned>(data_index), this->get_label().c_str());
     this->set_last_on_value(this->state);
   } 
   // Handle auto OFF state
@@ -184,11 +225,99 @@ void DataSensor::apply_state(int16_t event_index, bool switch_state, bool manual
   }
 }
 
+bool DataSensor::start_ramp_(float target) {
+  // A ramp cut short by the next event continues from the value it had reached
+  float start = this->is_ramping() ? this->ramp_value_ : this->last_on_value_;
+  this->cancel_ramp_();
+  if (this->ramp_mode_ == DATA_SENSOR_RAMP_NONE || this->ramp_duration_s_ == 0 ||
+      std::isnan(start) || std::isnan(target) || target == start) {
+    return false;
+  }
+  ScheduleTickService *service = this->parent_schedule_ != nullptr ? this->parent_schedule_->get_tick_service() : nullptr;
+  if (service == nullptr) {
+    return false;
+  }
+
+  float delta = target - start;
+  uint32_t steps;
+  if (this->ramp_mode_ == DATA_SENSOR_RAMP_STEP && this->ramp_step_ > 0.0f) {
+    steps = static_cast<uint32_t>(std::ceil(std::fabs(delta) / this->ramp_step_));
+  } else {
+    steps = this->ramp_duration_s_ / this->ramp_interval_s_;
+  }
+  // Bound the publish rate: never more than one value per ramp interval
+  uint32_t max_steps = std::max<uint32_t>(this->ramp_duration_s_ / this->ramp_interval_s_, 1);
+  steps = std::min(std::max<uint32_t>(steps, 1), max_steps);
+
+  this->ramp_value_ = start;
+  this->ramp_target_ = target;
+  // LAST_ON_VALUE shows the setpoint the schedule specified, never a value part-way along the ramp
+  this->last_on_value_ = target;
+  this->ramp_period_s_ = this->ramp_duration_s_ / steps;
+  this->ramp_steps_left_ = steps;
+  if (this->ramp_mode_ == DATA_SENSOR_RAMP_STEP && steps * this->ramp_step_ >= std::fabs(delta)) {
+    this->ramp_increment_ = delta > 0 ? this->ramp_step_ : -this->ramp_step_;
+  } else {
+    this->ramp_increment_ = delta / steps;
+  }
+
+  ESP_LOGD(TAG_DATA_SENSOR, "Sensor '%s': ramping %.2f -> %.2f in %u steps of %.3f every %us",
+           this->get_label().c_str(), this->ramp_value_, target, static_cast<unsigned>(steps),
+           this->ramp_increment_, static_cast<unsigned>(this->ramp_period_s_));
+
+  // Start from the previous ON or ramp value (the sensor may be showing its OFF value)
+  this->publish_value(this->ramp_value_);
+  if (!this->ramp_timer_.callback) {
+    this->ramp_timer_.callback = [this]() { this->advance_ramp_(); };
+  }
+  service->arm_timer(&this->ramp_timer_, this->ramp_period_s_);
+  return true;
+}
+
+void DataSensor::cancel_ramp_() {
+  if (this->ramp_steps_left_ == 0) {
+    return;
+  }
+  this->ramp_steps_left_ = 0;
+  if (this->parent_schedule_ != nullptr && this->parent_schedule_->get_tick_service() != nullptr) {
+    this->parent_schedule_->get_tick_service()->cancel_timer(&this->ramp_timer_);
+  }
+}
+
+void DataSensor::advance_ramp_() {
+  if (this->ramp_steps_left_ == 0) {
+    return;
+  }
+  // Land exactly on the target so float drift never accumulates past it
+  if (--this->ramp_steps_left_ == 0) {
+    this->ramp_value_ = this->ramp_target_;
+  } else {
+    this->ramp_value_ += this->ramp_increment_;
+  }
+  this->publish_value(this->ramp_value_);
+  if (this->ramp_steps_left_ > 0) {
+    this->parent_schedule_->get_tick_service()->arm_timer(&this->ramp_timer_, this->ramp_period_s_);
+  }
+}
+
 void DataSensor::set_max_schedule_data_entries(uint16_t size) {
   this->max_schedule_data_entries_ = size;
   ESP_LOGD(TAG_DATA_SENSOR, "Sensor %s set to %u entries", this->get_object_id().c_str(), this->max_schedule_data_entries_);
 }
 
+void DataSensor::resize_entries(uint16_t entries) {
+  this->max_schedule_data_entries_ = entries;
+  size_t bytes = entries * this->get_bytes_for_type(this->item_type_);
+  if (!this->combined_storage_ && this->array_pref_ != nullptr) {
+    this->array_pref_->resize(bytes);
+  }
+  // Before setup() the vector is still empty; setup() sizes it from the new entry count
+  if (this->total_bytes_ != 0) {
+    this->total_bytes_ = bytes;
+    this->data_vector_.resize(bytes, 0);
+  }
+}
+
 uint16_t DataSensor::get_bytes_for_type(uint16_t type) const {
   switch (type) {
     case 0:  // uint8_t
@@ -399,27 +528,44 @@ void DataSensor::load_data_from_pref_() {
     std::memcpy(this->data_vector_.data(), pref_data, size);
     ESP_LOGI(TAG_DATA_SENSOR, "Loaded %u bytes from preferences into local vector for sensor '%s'", 
              static_cast<unsigned>(size), this->get_label().c_str());
-  } else {
+  } else if (!this->migrate_data_from_pref_()) {
     ESP_LOGI(TAG_DATA_SENSOR, "No stored values for sensor '%s'; using defaults (zeros)", 
              this->get_label().c_str());
   }
 }
 
-void DataSensor::save_data_to_pref() {
+bool DataSensor::migrate_data_from_pref_() {
+  // The record was saved with another size or as a single blob: keep the entries that still fit
+  size_t stored_entries = this->parent_schedule_ != nullptr ? this->parent_schedule_->get_stored_data_entries() : 0;
+  std::vector<uint8_t> stored;
+  if (stored_entries == 0 ||
+      !this->array_pref_->load_resized(stored_entries * this->get_bytes_for_type(this->item_type_), stored,
+                                       this->parent_schedule_->stored_records_chunked())) {
+    return false;
+  }
+  size_t size = std::min(this->data_vector_.size(), stored.size());
+  std::memcpy(this->data_vector_.data(), stored.data(), size);
+  ESP_LOGI(TAG_DATA_SENSOR, "Migrated %u of %u stored entries for sensor '%s'",
+           static_cast<unsigned>(std::min<size_t>(stored_entries, this->max_schedule_data_entries_)),
+           static_cast<unsigned>(stored_entries), this->get_label().c_str());
+  return true;
+}
+
+void DataSensor::stage_data_to_pref() {
+  if (this->combined_storage_) {
+    // Copied into the parent schedule's record together with the event table
+    return;
+  }
   if (this->array_pref_ == nullptr) {
     ESP_LOGE(TAG_DATA_SENSOR, "array_pref is null for sensor '%s'", this->get_label().c_str());
     return;
   }
   
-  // Copy from local data_vector_ to array_pref
+  // Copy from local data_vector_ to array_pref; written to flash with the schedule's next generation
   uint8_t *pref_data = this->array_pref_->data();
   size_t size = std::min(this->data_vector_.size(), this->array_pref_->size());
   std::memcpy(pref_data, this->data_vector_.data(), size);
-  
-  // Save to persistent storage
-  this->array_pref_->save();
-  ESP_LOGI(TAG_DATA_SENSOR, "Saved %u bytes from local vector to preferences for sensor '%s'", 
-           static_cast<unsigned>(size), this->get_label().c_str());
+  ESP_LOGV(TAG_DATA_SENSOR, "Staged %u bytes for sensor '%s'", static_cast<unsigned>(size), this->get_label().c_str());
 }
 
 void DataSensor::log_data_sensor(std::string prefix) {
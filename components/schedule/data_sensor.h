@@ -4,6 +4,7 @@
 #include "esphome/core/log.h"
 #include "esphome/components/sensor/sensor.h"
 #include "array_preference.h"
+#include "schedule_timer_wheel.h"
 #include <vector>
 #include <string>
 #include <cstring>
@@ -29,6 +30,13 @@ enum DataSensorManualBehavior {
   DATA_SENSOR_MANUAL_BEHAVIOR_MANUAL_VALUE = 2
 };
 
+// Enum for data sensor ramp mode
+enum DataSensorRampMode {
+  DATA_SENSOR_RAMP_NONE = 0,
+  DATA_SENSOR_RAMP_LINEAR = 1,  // Evenly spaced updates every ramp interval
+  DATA_SENSOR_RAMP_STEP = 2     // Fixed-size steps of ramp_step, spread over the window
+};
+
 // DataSensor class
 class DataSensor : public sensor::Sensor {
  public:
@@ -43,12 +51,22 @@ class DataSensor : public sensor::Sensor {
   void set_label(const std::string &label) { this->label_ = label; }
   void set_item_type(uint16_t item_type) { this->item_type_ = item_type; }
   void set_max_schedule_data_entries(uint16_t size);
+  /** Grow with the parent schedule's capacity: stored entries are kept, new ones start at zero */
+  void resize_entries(uint16_t entries);
   void set_parent_schedule(Schedule *parent) { this->parent_schedule_ = parent; }
   void set_array_preference(ArrayPreferenceBase *array_pref) { this->array_pref_ = array_pref; }
+  ArrayPreferenceBase *get_array_preference() { return this->array_pref_; }
+  const ArrayPreferenceBase *get_array_preference() const { return this->array_pref_; }
+  /** Data is persisted by the parent schedule's combined record instead of an own preference */
+  void set_combined_storage(bool combined) { this->combined_storage_ = combined; }
   void set_manual_value(float value) { this->manual_value_ = value; }
   void set_manual_behavior(DataSensorManualBehavior behavior) { this->manual_behavior_ = behavior; }
   void set_off_behavior(DataSensorOffBehavior behavior) { this->off_behavior_ = behavior; }
   void set_off_value(float value) { this->off_value_ = value; }
+  void set_ramp_mode(DataSensorRampMode mode) { this->ramp_mode_ = mode; }
+  void set_ramp_duration(uint32_t seconds) { this->ramp_duration_s_ = seconds; }
+  void set_ramp_interval(uint32_t seconds) { this->ramp_interval_s_ = seconds > 0 ? seconds : 1; }
+  void set_ramp_step(float step) { this->ramp_step_ = step; }
 
   // Getters
   const std::string &get_label() const { return label_; }
@@ -59,6 +77,8 @@ class DataSensor : public sensor::Sensor {
   DataSensorManualBehavior get_manual_behavior() const { return manual_behavior_; }
   DataSensorOffBehavior get_off_behavior() const { return off_behavior_; }
   float get_off_value() const { return off_value_; }
+  DataSensorRampMode get_ramp_mode() const { return ramp_mode_; }
+  bool is_ramping() const { return this->ramp_steps_left_ > 0; }
   float get_last_on_value() const { return last_on_value_; }
   void set_last_on_value(float value) { this->last_on_value_ = value; }
   
@@ -94,25 +114,46 @@ class DataSensor : public sensor::Sensor {
   
   // Preference management
   uint32_t get_preference_hash() const;
-  void save_data_to_pref();  // Save from data_vector_ to array_pref_
+  void stage_data_to_pref();  // Copy data_vector_ into array_pref_; the parent schedule saves it with its generation
 
  protected:
   void create_preference_();
   void load_data_from_pref_();  // Load from array_pref_ to data_vector_
+  bool migrate_data_from_pref_();  // Load a record saved with another entry count (resaved by the schedule)
   const char* get_off_behavior_string() const;  // Helper to convert off_behavior enum to string
   const char* get_manual_behavior_string() const;  // Helper to convert manual_behavior enum to string
+  const char* get_ramp_mode_string() const;  // Helper to convert ramp_mode enum to string
+
+  // Ramp towards target from the last ON value; returns false when no ramp applies
+  bool start_ramp_(float target);
+  void cancel_ramp_();
+  void advance_ramp_();  // Timer callback: one incremental step, re-arms until the target is reached
   float manual_value_{0.0f};
   DataSensorManualBehavior manual_behavior_{DATA_SENSOR_MANUAL_BEHAVIOR_NAN};
   DataSensorOffBehavior off_behavior_{DATA_SENSOR_OFF_BEHAVIOR_NAN};
   float off_value_{0.0f};
   float last_on_value_{NAN};  // Store last ON value
 
+  // Ramp configuration
+  DataSensorRampMode ramp_mode_{DATA_SENSOR_RAMP_NONE};
+  uint32_t ramp_duration_s_{0};
+  uint32_t ramp_interval_s_{60};  // Minimum spacing between published ramp values
+  float ramp_step_{0.0f};
+  // Active ramp: value advances by ramp_increment_ every ramp_period_s_ until steps run out
+  float ramp_value_{NAN};
+  float ramp_target_{NAN};
+  float ramp_increment_{0.0f};
+  uint32_t ramp_period_s_{0};
+  uint32_t ramp_steps_left_{0};
+  WheelTimer ramp_timer_;
+
   std::string label_;
   uint16_t item_type_{0};
   size_t total_bytes_{0};
   uint16_t max_schedule_data_entries_{0};
   std::vector<uint8_t> data_vector_;  // Local working storage
   ArrayPreferenceBase *array_pref_{nullptr};  // Persistent storage
+  bool combined_storage_{false};
   Schedule *parent_schedule_{nullptr};
 };
 
@@ -1,17 +1,261 @@
 #include "event_based_schedulable.h"
 #include "schedule_event_mode_select.h"
 #include "esphome/core/log.h"
+#include <algorithm>
+#include <cstring>
 
 namespace esphome {
 namespace schedule {
 
 static const char *const TAG = "schedule.event_based";
 
+static constexpr uint16_t MINUTES_PER_WEEK = 7 * 1440;
+
+//==============================================================================
+// RECURRENCE RULES
+//==============================================================================
+
+uint16_t RecurrenceRule::minutes_until_next(uint16_t week_minute) const {
+  uint8_t day = week_minute / 1440;
+  uint16_t minute = week_minute % 1440;
+  // Later today, then the following days up to the same day next week
+  for (uint8_t ahead = 0; ahead <= 7; ahead++) {
+    if ((this->day_mask & (1u << ((day + ahead) % 7))) == 0) {
+      continue;
+    }
+    if (ahead > 0) {
+      return ahead * 1440 + this->from_minute - minute;
+    }
+    if (minute < this->from_minute) {
+      return this->from_minute - minute;
+    }
+    if (minute < this->last_of_day()) {
+      uint16_t fires = (minute - this->from_minute) / this->interval + 1;
+      return this->from_minute + fires * this->interval - minute;
+    }
+  }
+  return 0;
+}
+
+uint16_t RecurrenceRule::minutes_since_last(uint16_t week_minute) const {
+  uint8_t day = week_minute / 1440;
+  uint16_t minute = week_minute % 1440;
+  // Earlier today (or now), then the previous days back to the same day last week
+  for (uint8_t back = 0; back <= 7; back++) {
+    if ((this->day_mask & (1u << ((day + 7 - back) % 7))) == 0) {
+      continue;
+    }
+    if (back > 0) {
+      return back * 1440 + minute - this->last_of_day();
+    }
+    if (minute >= this->from_minute) {
+      uint16_t fires = std::min((minute - this->from_minute) / this->interval,
+                                (this->to_minute - this->from_minute) / this->interval);
+      return minute - (this->from_minute + fires * this->interval);
+    }
+  }
+  return 0xFFFF;
+}
+
+void EventBasedSchedulable::add_recurrence_rule(uint8_t day_mask, uint16_t from_minute, uint16_t to_minute,
+                                                uint16_t interval) {
+  if ((day_mask & 0x7F) == 0 || interval == 0 || from_minute > to_minute || to_minute >= 1440) {
+    ESP_LOGW(TAG, "Ignoring invalid recurrence rule");
+    return;
+  }
+  RecurrenceRule rule;
+  rule.day_mask = day_mask & 0x7F;
+  rule.from_minute = from_minute;
+  rule.to_minute = to_minute;
+  rule.interval = interval;
+  this->recurrence_rules_.push_back(rule);
+}
+
+uint16_t EventBasedSchedulable::minutes_to_next_rule_fire_(uint16_t week_minute) const {
+  uint16_t best = 0;
+  for (const auto &rule : this->recurrence_rules_) {
+    uint16_t ahead = rule.minutes_until_next(week_minute);
+    if (ahead != 0 && (best == 0 || ahead < best)) {
+      best = ahead;
+    }
+  }
+  return best;
+}
+
+//==============================================================================
+// REPEAT WINDOWS
+//==============================================================================
+
+// Stored as three packed uint16_t words per window
+static_assert(sizeof(EventRepeat) == 3 * sizeof(uint16_t), "EventRepeat must stay packed for storage");
+
+const EventRepeat *EventBasedSchedulable::find_event_repeat_(int16_t index) const {
+  if (index < 0 || this->event_repeats_.empty()) {
+    return nullptr;
+  }
+  auto it = std::lower_bound(this->event_repeats_.begin(), this->event_repeats_.end(), index,
+                             [](const EventRepeat &repeat, int16_t value) { return repeat.event_index < value; });
+  return (it != this->event_repeats_.end() && it->event_index == index) ? &*it : nullptr;
+}
+
+uint16_t EventBasedSchedulable::minutes_to_next_repeat_(int16_t table_next, uint16_t week_minute) const {
+  int16_t count = static_cast<int16_t>(this->schedule_event_count_);
+  if (table_next < 0 || count == 0) {
+    return 0;
+  }
+  // The open window, if any, belongs to the table event before the next one
+  int16_t window = (table_next + count - 1) % count;
+  const EventRepeat *repeat = this->find_event_repeat_(window);
+  if (repeat == nullptr) {
+    return 0;
+  }
+  uint16_t start = this->schedule_times_in_minutes_[window] & TIME_MASK;
+  uint16_t offset = (week_minute + MINUTES_PER_WEEK - start) % MINUTES_PER_WEEK;
+  uint16_t next = (offset / repeat->interval + 1) * repeat->interval;
+  return (offset < repeat->span && next < repeat->span) ? next - offset : 0;
+}
+
+uint16_t EventBasedSchedulable::minutes_since_last_repeat_(int16_t index, uint16_t week_minute) const {
+  const EventRepeat *repeat = this->find_event_repeat_(index);
+  if (repeat == nullptr) {
+    return 0xFFFF;
+  }
+  uint16_t start = this->schedule_times_in_minutes_[index] & TIME_MASK;
+  uint16_t offset = (week_minute + MINUTES_PER_WEEK - start) % MINUTES_PER_WEEK;
+  uint16_t fires = std::min(offset / repeat->interval, (repeat->span - 1) / repeat->interval);
+  return offset - fires * repeat->interval;
+}
+
+void EventBasedSchedulable::on_schedule_parsed_() {
+  this->event_repeats_.clear();
+  for (const auto &repeat : this->parsed_repeats_) {
+    // Windows of entries dropped by truncation go with them
+    if (repeat.event_index >= this->schedule_event_count_) {
+      break;
+    }
+    if (this->event_repeats_.size() >= this->max_repeat_windows_) {
+      ESP_LOGW(TAG, "More than %u repeat windows; the rest fire once", this->max_repeat_windows_);
+      break;
+    }
+    this->event_repeats_.push_back(repeat);
+  }
+  this->parsed_repeats_.clear();
+  this->parsed_repeats_.shrink_to_fit();
+  if (!this->event_repeats_.empty()) {
+    ESP_LOGI(TAG, "Schedule has %u repeat windows", static_cast<unsigned>(this->event_repeats_.size()));
+  }
+}
+
+void EventBasedSchedulable::on_entries_swapped_(size_t entry) {
+  bool moved = false;
+  for (auto &repeat : this->event_repeats_) {
+    if (repeat.event_index == entry) {
+      repeat.event_index++;
+      moved = true;
+    } else if (repeat.event_index == entry + 1) {
+      repeat.event_index--;
+      moved = true;
+    }
+  }
+  if (moved) {
+    std::sort(this->event_repeats_.begin(), this->event_repeats_.end(),
+              [](const EventRepeat &a, const EventRepeat &b) { return a.event_index < b.event_index; });
+  }
+}
+
+size_t EventBasedSchedulable::encode_schedule_storage_(uint8_t *buf, size_t capacity) {
+  size_t used_bytes = Schedule::encode_schedule_storage_(buf, capacity);
+  if (used_bytes == 0 || !this->stores_repeats_()) {
+    return used_bytes;
+  }
+  // [count, (index, span, interval) x count] after the table terminator
+  uint16_t count = static_cast<uint16_t>(this->event_repeats_.size());
+  size_t repeat_bytes = sizeof(count) + count * sizeof(EventRepeat);
+  if (used_bytes + repeat_bytes > capacity) {
+    return 0;
+  }
+  std::memcpy(buf + used_bytes, &count, sizeof(count));
+  std::memcpy(buf + used_bytes + sizeof(count), this->event_repeats_.data(), count * sizeof(EventRepeat));
+  return used_bytes + repeat_bytes;
+}
+
+bool EventBasedSchedulable::decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) {
+  this->event_repeats_.clear();
+  if (!Schedule::decode_schedule_storage_(buf, size, table)) {
+    return false;
+  }
+  if (!this->stores_repeats_()) {
+    return true;
+  }
+  // Schedules saved without repeat windows have a zeroed tail, read as a count of 0
+  size_t offset = this->stored_table_bytes_;
+  uint16_t count = 0;
+  if (offset + sizeof(count) <= size) {
+    std::memcpy(&count, buf + offset, sizeof(count));
+  }
+  if (count > this->max_repeat_windows_ || offset + sizeof(count) + count * sizeof(EventRepeat) > size) {
+    ESP_LOGW(TAG, "Stored repeat windows are not valid; events fire once");
+    return true;
+  }
+  this->event_repeats_.resize(count);
+  std::memcpy(this->event_repeats_.data(), buf + offset + sizeof(count), count * sizeof(EventRepeat));
+  // Drop anything that does not match the table (stale or corrupt windows)
+  size_t event_count = table.size() - 2;
+  uint16_t previous = 0;
+  auto invalid = [&previous, event_count](const EventRepeat &repeat) {
+    bool bad = repeat.event_index >= event_count || repeat.event_index < previous || repeat.interval == 0 ||
+               repeat.span < repeat.interval || repeat.span > 1440;
+    if (!bad) {
+      previous = repeat.event_index + 1;
+    }
+    return bad;
+  };
+  this->event_repeats_.erase(std::remove_if(this->event_repeats_.begin(), this->event_repeats_.end(), invalid),
+                             this->event_repeats_.end());
+  return true;
+}
+
+//==============================================================================
+// NEXT EVENT SELECTION
+//==============================================================================
+
+void EventBasedSchedulable::select_next_event_(int16_t table_next) {
+  this->table_next_index_ = table_next;
+  uint16_t current_minute = this->current_event_raw_ & TIME_MASK;
+  uint16_t rule_ahead = this->minutes_to_next_rule_fire_(current_minute);
+  uint16_t repeat_ahead = this->minutes_to_next_repeat_(table_next, current_minute);
+  
+  uint16_t table_ahead = MINUTES_PER_WEEK;
+  if (table_next >= 0) {
+    uint16_t table_minute = this->schedule_times_in_minutes_[table_next] & TIME_MASK;
+    table_ahead = (table_minute + MINUTES_PER_WEEK - current_minute) % MINUTES_PER_WEEK;
+    // Only the same event comes round again after a full week; other events may share the minute
+    if (table_ahead == 0 && table_next == this->current_event_index_) {
+      table_ahead = MINUTES_PER_WEEK;
+    }
+  }
+  
+  // The table event wins a tie, then a repeat, so data values are published
+  if (repeat_ahead != 0 && repeat_ahead < table_ahead && (rule_ahead == 0 || repeat_ahead <= rule_ahead)) {
+    // A repeat fires as its window's table event
+    this->next_event_raw_ = ((current_minute + repeat_ahead) % MINUTES_PER_WEEK) | SWITCH_STATE_BIT;
+    this->next_event_index_ = (table_next + this->schedule_event_count_ - 1) % this->schedule_event_count_;
+  } else if (rule_ahead != 0 && (table_next < 0 || rule_ahead < table_ahead)) {
+    this->next_event_raw_ = ((current_minute + rule_ahead) % MINUTES_PER_WEEK) | SWITCH_STATE_BIT;
+    this->next_event_index_ = RULE_EVENT_INDEX;
+  } else if (table_next >= 0) {
+    this->next_event_raw_ = this->schedule_times_in_minutes_[table_next];
+    this->next_event_index_ = table_next;
+  }
+}
+
 //==============================================================================
 // VIRTUAL METHOD OVERRIDES FROM BASE CLASS
 //==============================================================================
 
 void EventBasedSchedulable::on_schedule_empty_changed(bool is_empty) {
+  // Recurrence rules still produce events without HA schedule entries
+  is_empty = is_empty && this->recurrence_rules_.empty();
   if (this->mode_select_ != nullptr) {
     this->mode_select_->set_disabled_only_mode(is_empty);
     if (is_empty) {
@@ -23,59 +267,232 @@ void EventBasedSchedulable::on_schedule_empty_changed(bool is_empty) {
 }
 
 void EventBasedSchedulable::advance_to_next_event_() {
-  // Call base class implementation to handle common event advancement
-  Schedule::advance_to_next_event_();
+  if (!this->has_generated_events_()) {
+    // Call base class implementation to handle common event advancement
+    Schedule::advance_to_next_event_();
+    return;
+  }
   
-  // Event-based has no additional state to track (no ON/OFF)
-  // Just trigger the event when it occurs
+  // Merge the table with the generated events: a table event moves the table cursor on,
+  // a rule fire leaves it where it was and a repeat already points past its window
+  bool next_is_table_event = this->next_event_index_ >= 0;
+  this->current_event_raw_ = this->next_event_raw_;
+  this->current_event_index_ = this->next_event_index_;
+  int16_t table_next = this->table_next_index_;
+  if (next_is_table_event && this->schedule_event_count_ > 0) {
+    table_next = (this->current_event_index_ + 1) % this->schedule_event_count_;
+  }
+  this->select_next_event_(table_next);
 }
 
 void EventBasedSchedulable::check_and_advance_events_() {
-  // Get current time in minutes
-  auto now_time = this->time_->now();
-  uint16_t current_time_minutes = this->time_to_minutes_(now_time);
-  
-  // Check if we should advance to next event
-  if (!this->should_advance_to_next_event_(current_time_minutes)) {
+  // Drain every event that is due now, so entries sharing a minute fire in the same pass.
+  // Without a clock jump (handled by the re-seek) no more than one week of events can be due.
+  uint32_t now_second = this->tick_week_second_();
+  size_t limit = this->schedule_event_count_ + 1;
+  this->due_batch_.clear();
+  while (this->due_batch_.size() < limit && this->is_next_event_due_(now_second)) {
+    this->advance_to_next_event_();
+    // The expired deadline belongs to the first event; a lone weekly event is not due again
+    this->event_timer_fired_ = false;
+    this->due_batch_.push_back(this->current_event_index_);
+  }
+  if (this->due_batch_.empty()) {
     return;
   }
   
-  // Advance to next event
-  this->advance_to_next_event_();
-  
-  // Trigger the scheduled event (no state checking needed)
-  // The platform-specific apply_scheduled_state() will handle the action
+  // Data sensors hold one value, so publish the last firing entry's values once for the batch
+  for (auto it = this->due_batch_.rbegin(); it != this->due_batch_.rend(); ++it) {
+    if (this->event_fires_(*it)) {
+      this->set_data_sensors_(*it, true, false);
+      break;
+    }
+  }
+  if (this->due_batch_.size() > 1) {
+    ESP_LOGD(TAG, "Firing %u coincident events", static_cast<unsigned>(this->due_batch_.size()));
+  }
+  for (int16_t index : this->due_batch_) {
+    this->fire_event_(index, false);
+  }
+  this->display_event_based_events_();
 }
 
 void EventBasedSchedulable::initialize_schedule_operation_() {
   // Call base class implementation to find current/next events
   Schedule::initialize_schedule_operation_();
   
+  // The most recent of the table event, its latest repeat and the latest rule fire is current
+  if (this->has_generated_events_() && this->last_tick_.time_valid) {
+    uint16_t now_minute = this->last_tick_.week_minute;
+    int16_t table_next = -1;
+    uint16_t table_behind = MINUTES_PER_WEEK;
+    if (this->schedule_event_count_ > 0 && this->current_event_index_ >= 0) {
+      table_next = this->next_event_index_;
+      table_behind = (now_minute + MINUTES_PER_WEEK - (this->current_event_raw_ & TIME_MASK)) % MINUTES_PER_WEEK;
+      uint16_t repeat_behind = this->minutes_since_last_repeat_(this->current_event_index_, now_minute);
+      if (repeat_behind < table_behind) {
+        this->current_event_raw_ = ((now_minute + MINUTES_PER_WEEK - repeat_behind) % MINUTES_PER_WEEK) | SWITCH_STATE_BIT;
+        table_behind = repeat_behind;
+      }
+    }
+    uint16_t rule_behind = 0xFFFF;
+    for (const auto &rule : this->recurrence_rules_) {
+      rule_behind = std::min(rule_behind, rule.minutes_since_last(now_minute));
+    }
+    if (rule_behind < table_behind) {
+      this->current_event_raw_ =
+          ((now_minute + MINUTES_PER_WEEK - rule_behind % MINUTES_PER_WEEK) % MINUTES_PER_WEEK) | SWITCH_STATE_BIT;
+      this->current_event_index_ = RULE_EVENT_INDEX;
+    }
+    this->select_next_event_(table_next);
+  }
+  
   // Event-based doesn't need to initialize ON/OFF state or search for last ON values
   // Just ready to trigger events as they occur
   
   ESP_LOGD(TAG, "Event-based initialization complete, state: %d", this->current_state_);
 }
 
+int16_t EventBasedSchedulable::last_table_event_() const {
+  if (!this->has_generated_events_()) {
+    return this->current_event_index_;
+  }
+  // The current event may be a rule fire or repeat; the table cursor still names the table event after it
+  if (this->table_next_index_ < 0 || this->schedule_event_count_ == 0) {
+    return -1;
+  }
+  int16_t count = static_cast<int16_t>(this->schedule_event_count_);
+  return (this->table_next_index_ + count - 1) % count;
+}
+
+void EventBasedSchedulable::resync_after_clock_jump_(int32_t jump_s) {
+  int16_t old_index = this->last_table_event_();
+  
+  // Re-seek to the event that is current at the new wall time
+  Schedule::resync_after_clock_jump_(jump_s);
+  int16_t new_index = this->last_table_event_();
+  
+  // A backward jump only re-seeks; events in the repeated interval already fired
+  int16_t count = static_cast<int16_t>(this->schedule_event_count_);
+  if (jump_s <= 0 || count == 0 || old_index < 0 || new_index < 0) {
+    return;
+  }
+  
+  // Table events passed over: the distance around the table plus one full table per skipped week
+  uint32_t missed = (new_index - old_index + count) % count +
+                    (static_cast<uint32_t>(jump_s) / SECONDS_PER_WEEK) * count;
+  if (missed == 0) {
+    return;
+  }
+  
+  uint32_t to_fire = 0;
+  switch (this->catch_up_policy_) {
+    case CATCH_UP_SKIP:
+      break;
+    case CATCH_UP_LAST:
+      to_fire = 1;
+      break;
+    case CATCH_UP_REPLAY:
+      to_fire = std::min<uint32_t>(missed, this->catch_up_max_events_);
+      break;
+  }
+  
+  // Replay the most recent missed table events oldest first, ending on the last one passed
+  for (uint32_t j = to_fire; j-- > 0;) {
+    int16_t index = (new_index - static_cast<int32_t>(j % count) + count) % count;
+    this->fire_event_(index);
+  }
+  
+  uint32_t skipped = missed - to_fire;
+  if (skipped > 0) {
+    this->skipped_event_count_ += skipped;
+    if (this->skipped_events_sensor_ != nullptr) {
+      this->skipped_events_sensor_->publish_state(this->skipped_event_count_);
+    }
+  }
+  ESP_LOGW(TAG, "Clock jump passed %u event(s): fired %u, skipped %u",
+           static_cast<unsigned>(missed), static_cast<unsigned>(to_fire), static_cast<unsigned>(skipped));
+  
+  this->update_event_based_ui_();
+}
+
 //==============================================================================
 // EVENT-BASED HELPER METHODS
 //==============================================================================
 
-void EventBasedSchedulable::update_event_based_ui_() {
+bool EventBasedSchedulable::event_fires_(int16_t index) const {
+  // Rule fires carry no data values; a placeholder of an empty rotation week is not a real event
+  return index >= 0 && !this->is_day_off_() && (this->schedule_times_in_minutes_[index] & SWITCH_STATE_BIT) != 0;
+}
+
+void EventBasedSchedulable::fire_event_(int16_t index, bool publish_data) {
+  if (this->is_day_off_()) {
+    ESP_LOGD(TAG, "Event %d suppressed by day exception", index);
+    return;
+  }
+  // Rule fires carry no data values
+  if (index == RULE_EVENT_INDEX) {
+    ESP_LOGD(TAG, "Firing recurrence rule event");
+    this->apply_scheduled_state(true);
+    return;
+  }
+  // Placeholder of an empty rotation week, not a real event
+  if (!this->event_fires_(index)) {
+    return;
+  }
+  ESP_LOGD(TAG, "Firing event %d", index);
+  if (publish_data) {
+    this->set_data_sensors_(index, true, false);
+  }
+  this->apply_scheduled_state(true);
+}
+
+void EventBasedSchedulable::display_event_based_events_() {
+  // Today's events are suppressed by a day exception; do not show them as upcoming
+  if (this->is_day_off_()) {
+    this->display_current_next_events_("Day Off", "Day Off");
+    return;
+  }
   // For event-based, we show current event as "EVENT" and next event time
-  std::string current_text = "EVENT at " + this->format_event_time_(this->current_event_raw_ & TIME_MASK);
-  std::string next_text = "EVENT at " + this->format_event_time_(this->next_event_raw_ & TIME_MASK);
+  std::string current_text = "EVENT at " + this->format_event_time_(this->current_event_raw_ & TIME_MASK,
+                                                                    this->event_second_(this->current_event_index_));
+  std::string next_text = "EVENT at " + this->format_event_time_(this->next_event_raw_ & TIME_MASK,
+                                                                 this->event_second_(this->next_event_index_));
   
   this->display_current_next_events_(current_text, next_text);
+}
+
+void EventBasedSchedulable::update_event_based_ui_() {
+  this->display_event_based_events_();
   
-  // Update data sensors with current event index
-  this->set_data_sensors_(this->current_event_index_, true, false);
+  // Update data sensors with current event index (rule fires have no data, nor does a day off)
+  if (this->current_event_index_ >= 0 && !this->is_day_off_()) {
+    this->set_data_sensors_(this->current_event_index_, true, false);
+  }
 }
 
 //==============================================================================
 // LOGGING
 //==============================================================================
 
+void EventBasedSchedulable::dump_config_event_based_() {
+  const char *policy = "Last";
+  if (this->catch_up_policy_ == CATCH_UP_SKIP) {
+    policy = "Skip";
+  } else if (this->catch_up_policy_ == CATCH_UP_REPLAY) {
+    policy = "Replay";
+  }
+  ESP_LOGCONFIG(TAG,
+                "  Catch-up Policy: %s\n"
+                "  Catch-up Max Events: %u\n"
+                "  Skipped Events: %u\n"
+                "  Recurrence Rules: %u\n"
+                "  Repeat Windows: %u (max %u)",
+                policy, this->catch_up_max_events_, static_cast<unsigned>(this->skipped_event_count_),
+                static_cast<unsigned>(this->recurrence_rules_.size()),
+                static_cast<unsigned>(this->event_repeats_.size()), this->max_repeat_windows_);
+}
+
 void EventBasedSchedulable::log_schedule_data() {
   ESP_LOGI(TAG, "Event-Based Schedule Data:");
   ESP_LOGI(TAG, "Max Entries: %u", this->schedule_max_entries_);
@@ -103,6 +520,15 @@ void EventBasedSchedulable::log_schedule_data() {
   }
 
   ESP_LOGI(TAG, "Total Entries: %u", entry_count);
+  
+  for (const auto &repeat : this->event_repeats_) {
+    ESP_LOGI(TAG, "  Entry %u repeats every %u min for %u min", repeat.event_index, repeat.interval, repeat.span);
+  }
+  
+  for (const auto &rule : this->recurrence_rules_) {
+    ESP_LOGI(TAG, "  Rule: every %u min %02u:%02u-%02u:%02u, days 0x%02X", rule.interval,
+             rule.from_minute / 60, rule.from_minute % 60, rule.to_minute / 60, rule.to_minute % 60, rule.day_mask);
+  }
 }
 
 } // namespace schedule
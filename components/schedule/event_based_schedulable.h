@@ -23,6 +23,44 @@ enum EventBasedScheduleState {
   STATE_EVENT_READY = 5              // Ready to process events (enabled)
 };
 
+// What to do with events whose time was skipped by a forward clock jump
+enum CatchUpPolicy : uint8_t {
+  CATCH_UP_SKIP = 0,    // Fire nothing, only re-seek
+  CATCH_UP_LAST = 1,    // Fire the most recent missed event once
+  CATCH_UP_REPLAY = 2   // Fire the most recent missed events in order, up to the configured limit
+};
+
+/**
+ * RecurrenceRule - "every N minutes from HH:MM to HH:MM on these days"
+ *
+ * Eight bytes per rule instead of one schedule entry per occurrence. Fires are never
+ * expanded into the table; the next and previous fire are computed when needed.
+ */
+struct RecurrenceRule {
+  uint8_t day_mask{0x7F};      // Bit 0 = Monday ... bit 6 = Sunday
+  uint16_t from_minute{0};     // First fire of the day (minutes from midnight)
+  uint16_t to_minute{1439};    // No fire after this minute of the day (inclusive)
+  uint16_t interval{60};       // Minutes between fires
+  
+  /** Last fire of a day */
+  uint16_t last_of_day() const { return this->from_minute + (this->to_minute - this->from_minute) / this->interval * this->interval; }
+  /** Minutes from week_minute to the next fire strictly after it (1 ... one week), 0 if it never fires */
+  uint16_t minutes_until_next(uint16_t week_minute) const;
+  /** Minutes since the latest fire at or before week_minute, 0xFFFF if it never fires */
+  uint16_t minutes_since_last(uint16_t week_minute) const;
+};
+
+/**
+ * EventRepeat - an HA entry that fires every interval minutes within its from/to window
+ *
+ * Only the window's first event is in the table; the repeats are computed when needed.
+ */
+struct EventRepeat {
+  uint16_t event_index;  // Table index of the window's first event
+  uint16_t span;         // Window length in minutes (to - from); repeats fire strictly before the end
+  uint16_t interval;     // Minutes between fires
+};
+
 /**
  * EventBasedSchedulable - For components that only need event triggers
  * 
@@ -67,14 +105,54 @@ class EventBasedSchedulable : public Schedule {
     this->mode_select_ = mode_select;
   }
   
+  //============================================================================
+  // CLOCK JUMP CATCH-UP
+  //============================================================================
+  
+  void set_catch_up_policy(CatchUpPolicy policy) { this->catch_up_policy_ = policy; }
+  void set_catch_up_max_events(uint16_t max_events) { this->catch_up_max_events_ = max_events; }
+  void set_skipped_events_sensor(sensor::Sensor *sensor) { this->skipped_events_sensor_ = sensor; }
+  
+  /** Number of events missed by clock jumps and not fired under the catch-up policy */
+  uint32_t get_skipped_event_count() const { return this->skipped_event_count_; }
+  
+  //============================================================================
+  // RECURRENCE RULES
+  //============================================================================
+  
+  /** Fire every interval minutes from from_minute to to_minute on the days in day_mask (bit 0 = Monday)
+   * Rule fires merge with the HA schedule's events but carry no data values.
+   */
+  void add_recurrence_rule(uint8_t day_mask, uint16_t from_minute, uint16_t to_minute, uint16_t interval);
+  const std::vector<RecurrenceRule> &get_recurrence_rules() const { return this->recurrence_rules_; }
+  
+  //============================================================================
+  // REPEAT WINDOWS
+  //============================================================================
+  
+  /** Maximum HA entries that may carry a "repeat" interval (0 = repeat intervals ignored)
+   * Each window adds 6 bytes to the schedule preference.
+   */
+  void set_max_repeat_windows(uint16_t max_windows) { this->max_repeat_windows_ = max_windows; }
+  const std::vector<EventRepeat> &get_event_repeats() const { return this->event_repeats_; }
+  
   // Logging - event-based format (single events, not ON/OFF pairs)
   void log_schedule_data() override;
   
+  /** Log the event-based configuration (called from the platform dump_config) */
+  void dump_config_event_based_();
+  
   /** Event-based components use simplified loop without state machine 
    * Only checks for event times and triggers apply_scheduled_state(true)
+   * Runs on the shared tick instead of polling from loop()
    */
-  void loop() override {
-    uint32_t now = millis();
+  void process_tick(const ScheduleTick &tick) override {
+    this->last_tick_ = tick;
+    this->apply_rotation_week_();
+    this->apply_solar_day_();
+    this->apply_day_exception_();
+    this->apply_dst_rules_();
+    uint32_t now = tick.millis;
     
     // Periodic logging every 60 seconds
     if (now - this->last_state_log_time_ >= 60000) {
@@ -83,82 +161,95 @@ class EventBasedSchedulable : public Schedule {
       ESP_LOGV("schedule", "Event-based loop state: %d", this->current_state_);
     }
     
-    // Run every second
-    if (now - this->last_time_check_ >= 1000) {
-      this->last_time_check_ = now;
-      
-      // Check prerequisites (returns error code)
-      auto prereq_error = this->check_prerequisites_();
-      
-      // Handle prerequisite errors with state transitions
-      if (prereq_error == PREREQ_TIME_INVALID) {
-        if (this->current_state_ != STATE_EVENT_TIME_INVALID) {
-          ESP_LOGW("schedule", "Time is not valid, schedule operations paused");
-          this->current_state_ = STATE_EVENT_TIME_INVALID;
-        }
-        this->display_current_next_events_("Time Invalid", "Time Invalid");
-        return;
+    // Only called by the tick service when a timer expired or a wakeup was requested;
+    // poll again in a second unless this pass arms the next event deadline
+    this->last_time_check_ = now;
+    this->arm_poll_timer_();
+    
+    // Check prerequisites (returns error code)
+    auto prereq_error = this->check_prerequisites_();
+    // Recurrence rules keep firing while the HA schedule has no entries
+    if (prereq_error == PREREQ_SCHEDULE_EMPTY && !this->recurrence_rules_.empty()) {
+      prereq_error = PREREQ_OK;
+    }
+    
+    // Handle prerequisite errors with state transitions
+    if (prereq_error == PREREQ_TIME_INVALID) {
+      if (this->current_state_ != STATE_EVENT_TIME_INVALID) {
+        ESP_LOGW("schedule", "Time is not valid, schedule operations paused");
+        this->current_state_ = STATE_EVENT_TIME_INVALID;
       }
-      
-      if (prereq_error == PREREQ_SCHEDULE_INVALID) {
-        if (this->current_state_ != STATE_EVENT_SCHEDULE_INVALID) {
-          ESP_LOGW("schedule", "Schedule is not valid");
-          this->current_state_ = STATE_EVENT_SCHEDULE_INVALID;
-        }
-        this->display_current_next_events_("Schedule Invalid", "Schedule Invalid");
-        return;
+      this->display_current_next_events_("Time Invalid", "Time Invalid");
+      return;
+    }
+    
+    if (prereq_error == PREREQ_SCHEDULE_INVALID) {
+      if (this->current_state_ != STATE_EVENT_SCHEDULE_INVALID) {
+        ESP_LOGW("schedule", "Schedule is not valid");
+        this->current_state_ = STATE_EVENT_SCHEDULE_INVALID;
       }
-      
-      if (prereq_error == PREREQ_SCHEDULE_EMPTY) {
-        if (this->current_state_ != STATE_EVENT_SCHEDULE_EMPTY) {
-          ESP_LOGI("schedule", "Schedule is empty, no events to process");
-          this->current_state_ = STATE_EVENT_SCHEDULE_EMPTY;
-        }
-        this->display_current_next_events_("Schedule Empty", "Schedule Empty");
-        return;
+      this->display_current_next_events_("Schedule Invalid", "Schedule Invalid");
+      return;
+    }
+    
+    if (prereq_error == PREREQ_SCHEDULE_EMPTY) {
+      if (this->current_state_ != STATE_EVENT_SCHEDULE_EMPTY) {
+        ESP_LOGI("schedule", "Schedule is empty, no events to process");
+        this->current_state_ = STATE_EVENT_SCHEDULE_EMPTY;
       }
+      this->display_current_next_events_("Schedule Empty", "Schedule Empty");
+      return;
+    }
+    
+    // Prerequisites OK - transition from error states to INIT if needed
+    if ((this->current_state_ == STATE_EVENT_TIME_INVALID || 
+         this->current_state_ == STATE_EVENT_SCHEDULE_INVALID || 
+         this->current_state_ == STATE_EVENT_SCHEDULE_EMPTY) && 
+        prereq_error == PREREQ_OK) {
+      this->current_state_ = STATE_EVENT_INIT;
+      ESP_LOGV("schedule", "Prerequisites met, transitioning to INIT state");
+    }
+    
+    // Handle initialization
+    if (this->current_state_ == STATE_EVENT_INIT) {
+      // Call base class initialization to find current/next events
+      this->initialize_schedule_operation_();
       
-      // Prerequisites OK - transition from error states to INIT if needed
-      if ((this->current_state_ == STATE_EVENT_TIME_INVALID || 
-           this->current_state_ == STATE_EVENT_SCHEDULE_INVALID || 
-           this->current_state_ == STATE_EVENT_SCHEDULE_EMPTY) && 
-          prereq_error == PREREQ_OK) {
-        this->current_state_ = STATE_EVENT_INIT;
-        ESP_LOGV("schedule", "Prerequisites met, transitioning to INIT state");
+      // Transition to event-ready state and mark that we need initial UI update
+      this->current_state_ = STATE_EVENT_READY;
+      this->needs_initial_ui_update_ = true;
+      return;
+    }
+    
+    // Check if mode select disabled the schedule
+    if (this->current_state_ == STATE_EVENT_DISABLED) {
+      this->display_current_next_events_("Disabled", "Disabled");
+      return;
+    }
+    
+    // Normal operation - process events
+    if (this->current_state_ == STATE_EVENT_READY) {
+      // Force UI update on first loop after initialization
+      if (this->needs_initial_ui_update_) {
+        this->update_event_based_ui_();
+        this->needs_initial_ui_update_ = false;
       }
       
-      // Handle initialization
-      if (this->current_state_ == STATE_EVENT_INIT) {
-        // Call base class initialization to find current/next events
+      // Re-seek and apply the catch-up policy if the wall clock jumped
+      int32_t clock_jump_s = this->detect_clock_jump_();
+      if (clock_jump_s != 0) {
+        this->resync_after_clock_jump_(clock_jump_s);
+      } else if (this->take_day_pattern_change_()) {
+        // Today's pattern changed (day exception or rotation week): re-seek
         this->initialize_schedule_operation_();
-        
-        // Transition to event-ready state and mark that we need initial UI update
-        this->current_state_ = STATE_EVENT_READY;
-        this->needs_initial_ui_update_ = true;
-        return;
+        this->update_event_based_ui_();
       }
       
-      // Check if mode select disabled the schedule
-      if (this->current_state_ == STATE_EVENT_DISABLED) {
-        this->display_current_next_events_("Disabled", "Disabled");
-        return;
-      }
+      // Fire every due event as one batch (updates the UI once if any fired)
+      this->check_and_advance_events_();
       
-      // Normal operation - process events
-      if (this->current_state_ == STATE_EVENT_READY) {
-        // Force UI update on first loop after initialization
-        if (this->needs_initial_ui_update_) {
-          this->update_event_based_ui_();
-          this->needs_initial_ui_update_ = false;
-        }
-        
-        // Check if we should trigger the event and update UI if events changed
-        int old_index = this->current_event_index_;
-        this->check_and_advance_events_();
-        if (old_index != this->current_event_index_) {
-          this->update_event_based_ui_();
-        }
-      }
+      // Idle until the next event is due
+      this->arm_event_deadline_();
     }
   }
   
@@ -170,6 +261,9 @@ class EventBasedSchedulable : public Schedule {
   void advance_to_next_event_() override;
   void check_and_advance_events_() override;
   void initialize_schedule_operation_() override;
+  void resync_after_clock_jump_(int32_t jump_s) override;
+  /** Lead triggers fire only while the schedule is enabled and running */
+  bool lead_triggers_enabled_() const override { return this->current_state_ == STATE_EVENT_READY; }
   
   /** Parse schedule entry for event-based storage
    * 
@@ -180,28 +274,93 @@ class EventBasedSchedulable : public Schedule {
   void parse_schedule_entry(const JsonObjectConst &entry, 
                            std::vector<uint16_t> &work_buffer,
                            uint16_t day_offset) override {
-    // Event-based: Extract only "from" time (ignore "to")
-    uint16_t event_time = this->timeToMinutes_(entry["from"]) + 0x4000;  // Set bit 14
+    // Event-based: Extract only "from" time ("to" only bounds a repeat window)
+    uint16_t from = this->timeToMinutes_(entry["from"]);
+    uint16_t event_time = from + 0x4000;  // Set bit 14
+    
+    // A new week starts with an empty work buffer
+    if (work_buffer.empty()) {
+      this->parsed_repeats_.clear();
+    }
+    
+    // A "repeat" interval in the entry's data fires every N minutes until "to"
+    JsonVariantConst repeat = entry["data"]["repeat"];
+    if (this->stores_repeats_() && repeat.is<int>()) {
+      int interval = repeat.as<int>();
+      uint16_t to = this->timeToMinutes_(entry["to"]);
+      // Ignore windows too short to repeat at all
+      if (interval >= 1 && interval <= 1440 && to >= from + interval) {
+        EventRepeat window;
+        window.event_index = static_cast<uint16_t>(work_buffer.size());
+        window.span = to - from;
+        window.interval = static_cast<uint16_t>(interval);
+        this->parsed_repeats_.push_back(window);
+      }
+    }
     
     // Add only the event time (no OFF time)
     work_buffer.push_back(event_time + day_offset);
     
-    // NOTE: "to" time from HA schedule is ignored
-    // The component only cares about when the event triggers
+    // Keep the seconds HA sends when running at second resolution
+    if (this->second_resolution_) {
+      this->parsed_seconds_.push_back(this->timeToSeconds_(entry["from"]));
+    }
+    
   }
   
+  /** Raw event table followed by the repeat windows: [count, (index, span, interval) x count] */
+  size_t encode_schedule_storage_(uint8_t *buf, size_t capacity) override;
+  bool decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) override;
+  /** Adopt the repeat windows found while parsing */
+  void on_schedule_parsed_() override;
+  /** Keep repeat windows with their entries when solar times re-sort the table */
+  void on_entries_swapped_(size_t entry) override;
+  
   //============================================================================
   // EVENT-BASED HELPER METHODS
   //============================================================================
   
   /** Update event-based UI (sensors and displays) */
   void update_event_based_ui_();
+  /** Publish the current/next event text sensors only */
+  void display_event_based_events_();
+  
+  /** Publish the event's data values (unless publish_data is false) and trigger the platform action */
+  void fire_event_(int16_t index, bool publish_data = true);
+  /** Whether index is a table event that fires today (not a rotation placeholder or a day off) */
+  bool event_fires_(int16_t index) const;
+  
+  // current/next index of an event generated by a recurrence rule (not in the table)
+  static constexpr int16_t RULE_EVENT_INDEX = -2;
+  
+  /** Minutes from week_minute to the earliest rule fire after it, 0 if no rule fires */
+  uint16_t minutes_to_next_rule_fire_(uint16_t week_minute) const;
+  /** Pick the next event after the current one: the table event table_next (-1 if none)
+   * or the next rule fire, whichever comes first (the table wins a tie)
+   */
+  void select_next_event_(int16_t table_next);
+  
+  /** Repeat windows are kept with the plain minute table only */
+  bool stores_repeats_() const {
+    return this->max_repeat_windows_ > 0 && !this->second_resolution_ && !this->is_rotating_();
+  }
+  /** Rules or repeat windows produce events that are not in the table */
+  bool has_generated_events_() const { return !this->recurrence_rules_.empty() || !this->event_repeats_.empty(); }
+  /** Table event most recently passed, whether or not a rule fire or repeat is the current event */
+  int16_t last_table_event_() const;
+  /** Repeat window started by the table event at index, nullptr if it fires once */
+  const EventRepeat *find_event_repeat_(int16_t index) const;
+  /** Minutes from week_minute to the next repeat of the window before table_next, 0 if none is left */
+  uint16_t minutes_to_next_repeat_(int16_t table_next, uint16_t week_minute) const;
+  /** Minutes since the latest repeat of the window started by index at or before week_minute, 0xFFFF if none */
+  uint16_t minutes_since_last_repeat_(int16_t index, uint16_t week_minute) const;
   
   /** Force reinitialization after schedule update */
   void force_reinitialize() {
     ESP_LOGD("schedule.event_based", "Forcing reinitialization");
     this->current_state_ = STATE_EVENT_INIT;
     this->needs_initial_ui_update_ = true;
+    this->request_wakeup_();
   }
   
   /** Update mode select options when schedule empty state changes */
@@ -219,6 +378,24 @@ class EventBasedSchedulable : public Schedule {
   
   // Flag to ensure UI is updated after initialization
   bool needs_initial_ui_update_{false};
+  
+  // Clock jump catch-up
+  CatchUpPolicy catch_up_policy_{CATCH_UP_LAST};
+  uint16_t catch_up_max_events_{5};
+  uint32_t skipped_event_count_{0};
+  sensor::Sensor *skipped_events_sensor_{nullptr};
+  
+  // Recurrence rules and the table event that follows while a rule fire is current or next
+  std::vector<RecurrenceRule> recurrence_rules_;
+  int16_t table_next_index_{-1};
+  
+  // Events drained by the current check_and_advance_events_() pass (capacity reused)
+  std::vector<int16_t> due_batch_;
+  
+  // Repeat windows sorted by event index (parsed_repeats_ collects them during an HA update)
+  std::vector<EventRepeat> event_repeats_;
+  std::vector<EventRepeat> parsed_repeats_;
+  uint16_t max_repeat_windows_{0};
 };
 
 } // namespace schedule
@@ -2,6 +2,7 @@
 #include "schedule.h"
 #include "data_sensor.h"
 
+#include <algorithm>
 #include <functional>
 
 namespace esphome {
@@ -79,16 +80,22 @@ void UpdateScheduleButton::press_action() {
 
 void Schedule::set_max_schedule_entries(size_t entries) {
     this->schedule_max_entries_ = entries; 
-    this->set_max_schedule_size(entries);  //This will set the size of schedule_times_in_minutes_ vector in bytes
+    this->set_max_schedule_size(entries);  //This will set the capacity of schedule_times_in_minutes_ in uint16_t values
 }
 
 void Schedule::set_max_schedule_size(size_t size) {
     // Use virtual method to get multiplier based on storage type
     // State-based: 2 (ON + OFF per entry)
     // Event-based: 1 (EVENT only per entry)
+    if (this->get_storage_type() == STORAGE_TYPE_BITMAP) {
+        // The stored size is fixed by the bitmap; every minute of the week may be a transition
+        this->schedule_max_size_ = WeekBitmap::MINUTES_PER_WEEK + 2;
+        return;
+    }
     size_t multiplier = this->get_storage_multiplier();
     this->schedule_max_size_ = (size * multiplier) + 2;  // entries * multiplier + 2 uint16_t terminator
-    this->schedule_times_in_minutes_.resize(this->schedule_max_size_); 
+    // The runtime table is kept at its real length; only capacity is reserved here
+    this->schedule_times_in_minutes_.reserve(this->schedule_max_size_);
 }
 
 void Schedule::set_schedule_entity_id(const std::string &ha_schedule_entity_id){
@@ -99,22 +106,58 @@ void Schedule::setup() {
     ESP_LOGI(TAG, "Setting up");
     
     // Check if device time is valid
-    this->check_rtc_time_valid_();
+    this->check_rtc_time_valid_(this->time_ != nullptr ? this->time_->now() : ESPTime{});
+    
+    if (this->tick_service_ == nullptr) {
+        ESP_LOGE(TAG, "No tick service registered; schedule will not run");
+    }
+    
+    // The event timer only queues this schedule; the work happens in process_tick()
+    this->event_timer_.callback = [this]() {
+        this->event_timer_fired_ = this->event_timer_is_deadline_;
+        this->request_wakeup_();
+    };
+    
+    // Any time sync may move the wall clock, so re-evaluate the armed deadline
+    if (this->time_ != nullptr) {
+        this->time_->add_on_time_sync_callback([this]() { this->request_wakeup_(); });
+    }
+    
+    // Companion records, created once and reused: on ESP32 every make_preference() allocates a backend
+    this->storage_footprint_pref_ =
+        global_preferences->make_preference<StorageFootprint>(fnv1_hash("storage_footprint") ^ this->get_object_id_hash());
+    this->slot_pointer_pref_ =
+        global_preferences->make_preference<SlotPointer>(fnv1_hash("slot_pointer") ^ this->get_object_id_hash());
+    // Sizes the records were last saved with, so data sensors can migrate a resized record
+    this->load_storage_footprint_();
+    // Committed A/B slot, before any record is created or loaded
+    this->load_slot_pointer_();
+    // Capacity grown by an earlier, larger schedule is restored before the records are loaded
+    if (this->stored_records_chunked()) {
+        this->grow_schedule_capacity_(std::min<size_t>(this->storage_footprint_.entries, this->get_schedule_size_limit()));
+        if (this->sched_array_pref_ != nullptr && this->storage_footprint_.record_bytes > this->sched_array_pref_->size()) {
+            this->sched_array_pref_->resize(std::min<size_t>(this->storage_footprint_.record_bytes,
+                                                             this->sched_array_pref_->max_size()));
+        }
+    }
     
     // Set parent reference and call setup on each data sensor
     // The data sensors hold the attribute data that are supplied by the service call
     for (auto *sensor : this->data_sensors_) {
         sensor->set_parent_schedule(this);
+        // Combined storage: the sensor's column is loaded and saved with the schedule record
+        sensor->set_combined_storage(this->combined_storage_);
         sensor->setup();
     }
     // Create schedule preference object
     this->create_schedule_preference();
     // Now load from preference;
     this->load_schedule_from_pref_();
+    this->publish_pref_write_counts_();
     
     // Load stored entity ID and check if it changed
     this->load_entity_id_from_pref_();
-    uint32_t current_hash = fnv1_hash(this->ha_schedule_entity_id_);
+    uint32_t current_hash = this->entity_ids_hash_();
     this->entity_id_changed_ = (this->stored_entity_id_hash_ != current_hash);
     if (this->entity_id_changed_) {
         ESP_LOGI(TAG, "Schedule entity ID changed (hash: 0x%08X -> 0x%08X)",
@@ -155,6 +198,9 @@ void Schedule::setup() {
     if (this->next_event_sensor_ != nullptr) {
         this->next_event_sensor_->publish_state("Initializing...");
     }
+    
+    // Run the first pass on the next loop
+    this->request_wakeup_();
 }
 
 void Schedule::dump_config_base() {
@@ -163,6 +209,7 @@ void Schedule::dump_config_base() {
                   "  Entity ID: %s\n"
                   "  Max Entries: %d\n"
                   "  Max Size: %d bytes\n"
+                  "  Size Limit: %u entries\n"
                   "  Object ID: %s\n"
                   "  Preference Hash: %u\n"
                   "  Object Hash ID: %u\n"
@@ -170,10 +217,12 @@ void Schedule::dump_config_base() {
                   "  HA Connected: %s\n"
                   "  RTC Valid: %s\n"
                   "  Valid: %s\n"
-                  "  Empty: %s",
+                  "  Empty: %s\n"
+                  "  Resolution: %s",
                   ha_schedule_entity_id_.c_str(),
                   schedule_max_entries_,
                   schedule_max_size_,
+                  static_cast<unsigned>(this->get_schedule_size_limit()),
                   this->get_object_id().c_str(),
                   this->get_preference_hash(),
                   this->get_object_id_hash(),
@@ -181,7 +230,26 @@ void Schedule::dump_config_base() {
                   this->ha_connected_ ? "Yes" : "No",
                   this->rtc_time_valid_ ? "Yes" : "No",
                   this->schedule_valid_ ? "Yes" : "No",
-                  this->schedule_empty_ ? "Yes" : "No");
+                  this->schedule_empty_ ? "Yes" : "No",
+                  this->second_resolution_ ? "Second" : "Minute");
+    if (this->is_rotating_()) {
+        ESP_LOGCONFIG(TAG, "  Rotation: %u weeks (active week %u, %u distinct day patterns)",
+                      static_cast<unsigned>(this->get_rotation_weeks()), this->active_rotation_week_,
+                      static_cast<unsigned>(this->rotation_pattern_offsets_.size()));
+    }
+    if (this->day_exceptions_ != nullptr) {
+        uint16_t exception_days = 0;
+        for (uint16_t key = 0; key < DAYS_PER_EXCEPTION_TABLE; key++) {
+            if (this->day_exceptions_[key] != DAY_EXCEPTION_NONE) {
+                exception_days++;
+            }
+        }
+        ESP_LOGCONFIG(TAG, "  Day Exceptions: %u days", exception_days);
+    }
+    if (this->solar_table_ != nullptr) {
+        ESP_LOGCONFIG(TAG, "  Solar: %.2f, %.2f (%u solar times)", this->solar_table_->get_latitude(),
+                      this->solar_table_->get_longitude(), static_cast<unsigned>(this->solar_anchors_.size()));
+    }
     ESP_LOGCONFIG(TAG, "Registered Data Sensors:");
     for (auto *sensor : this->data_sensors_) {
         sensor->dump_config();
@@ -195,7 +263,7 @@ void Schedule::dump_config_base() {
 Schedule::PrerequisiteError Schedule::check_prerequisites_() {
     // Check time validity
     if (!this->rtc_time_valid_) {
-        this->check_rtc_time_valid_();
+        this->check_rtc_time_valid_(this->last_tick_.now);
         if (!this->rtc_time_valid_) {
             return PREREQ_TIME_INVALID;
         }
@@ -207,7 +275,7 @@ Schedule::PrerequisiteError Schedule::check_prerequisites_() {
         uint32_t check_interval = this->ha_connected_once_ ? 60000 : 5000;
         if (now - this->last_connection_check_ >= check_interval) {
             this->last_connection_check_ = now;
-            this->check_ha_connection_();
+            this->check_ha_connection_(this->last_tick_.api_connected);
             
             // If we just reconnected, request schedule update if configured or needed
             if ((this->ha_connected_ && this->update_on_reconnect_) || 
@@ -247,9 +315,8 @@ Schedule::PrerequisiteError Schedule::check_prerequisites_() {
     return PREREQ_OK;
 }
 
-void Schedule::check_rtc_time_valid_() {
+void Schedule::check_rtc_time_valid_(const ESPTime &now) {
     if (this->time_ != nullptr) {
-        auto now = this->time_->now();
         if (!now.is_valid()) {
             if (this->rtc_time_valid_) {
                 // Time was valid but now is not (shouldn't normally happen)
@@ -283,9 +350,7 @@ void Schedule::check_rtc_time_valid_() {
     }
 }
 
-void Schedule::check_ha_connection_() {
-    bool connected = api::global_api_server->is_connected();
-    
+void Schedule::check_ha_connection_(bool connected) {
     // If connection state changed
     if (this->ha_connected_ != connected) {
       if (connected) {
@@ -315,26 +380,29 @@ void Schedule::log_state_flags_() {
 
 void Schedule::initialize_schedule_operation_() {
     ESP_LOGI(TAG, "Initializing operation");
+    this->event_timer_fired_ = false;
+    this->last_pass_timestamp_ = 0;
+    // The lookup below already runs against today's exception
+    this->day_pattern_changed_ = false;
     
     if (this->time_ == nullptr) {
         ESP_LOGW(TAG, "Cannot initialize schedule operation: no time component");
         return;
     }
     
-    // Get current time
-    auto now = this->time_->now();
-    if (!now.is_valid()) {
+    // Use the shared tick snapshot for the current time
+    const ESPTime &now = this->last_tick_.now;
+    if (!this->last_tick_.time_valid) {
         ESP_LOGW(TAG, "Cannot initialize schedule operation: invalid time");
         return;
     }
-    // Calculate current time in minutes from start of week
-    uint16_t current_time_minutes = this->time_to_minutes_(now);
+    uint16_t current_time_minutes = this->last_tick_.week_minute;
     
     ESP_LOGD(TAG, "Current time: Day %u, %02d:%02d (week minute: %u)", 
              now.day_of_week, now.hour, now.minute, current_time_minutes);
     
     // Find current active event
-    current_event_index_ = this->find_current_event_(current_time_minutes);
+    current_event_index_ = this->find_current_event_(current_time_minutes, now.second);
     // we should not get here with an invalid index as schedule is valid
     if (current_event_index_ < 0) {
         ESP_LOGW(TAG, "No current event found, schedule is empty");
@@ -349,24 +417,22 @@ void Schedule::initialize_schedule_operation_() {
     
     // Check if current time is less than current event time
     // This means all events are in the future and we wrapped to the last event
-    bool all_events_in_future = (current_time_minutes < current_event_time);
+    bool all_events_in_future = (this->tick_week_second_() < this->event_week_second_(current_event_index_, current_event_raw_));
     
     if (all_events_in_future) {
         // We're before the first event of the week, so next event is the first event
         ESP_LOGD(TAG, "All events in future, next event is first event of new week");
         this->next_event_raw_ = this->schedule_times_in_minutes_[0];
         this->next_event_index_ = 0;
+    } else if (static_cast<size_t>(current_event_index_ + 1) >= this->schedule_event_count_) {
+        // End of schedule reached, roll over to start of schedule
+        ESP_LOGI(TAG, "End of schedule reached, rolling over to start of schedule");
+        this->next_event_raw_ = this->schedule_times_in_minutes_[0];
+        this->next_event_index_ = 0;
     } else {
         // Normal case: get the next event after current
         this->next_event_raw_ = this->schedule_times_in_minutes_[current_event_index_ + 1];
         this->next_event_index_ = current_event_index_ + 1;
-        
-        if (this->next_event_raw_ == 0xFFFF) {
-            // End of schedule reached, roll over to start of schedule
-            ESP_LOGI(TAG, "End of schedule reached, rolling over to start of schedule");
-            this->next_event_raw_ = this->schedule_times_in_minutes_[0];
-            this->next_event_index_ = 0;
-        }
     }
     
 	ESP_LOGV(TAG,"current_event_raw_: 0x%04X, next_event_raw_: 0x%04X current_event_index: %d, next_event_index: %d", this->current_event_raw_, this->next_event_raw_, current_event_index_, this->next_event_index_);
@@ -376,77 +442,83 @@ void Schedule::initialize_schedule_operation_() {
     bool in_event = (this->current_event_raw_ & SWITCH_STATE_BIT) != 0;
     
     ESP_LOGV(TAG, "Current event index: %d, time: %s, state: %s", 
-             current_event_index_, this->format_event_time_(current_event_time).c_str(), in_event ? "ON" : "OFF");
+             current_event_index_, this->format_event_time_(current_event_time, this->event_second_(current_event_index_)).c_str(), in_event ? "ON" : "OFF");
     
     ESP_LOGD(TAG, "Schedule operation initialized");
 }
 
-int16_t Schedule::find_current_event_(uint16_t current_time_minutes) {
-    const uint16_t TIME_MASK = 0x3FFF;  // Mask to extract time (bits 0-13)
+int16_t Schedule::find_current_event_(uint16_t current_time_minutes, uint8_t current_second) const {
+    if (this->schedule_event_count_ == 0) {
+        return -1;
+    }
     
-    int16_t current_index = -1;  // No event yet
+    // Jump to today's bucket, then binary search it for the first event after the current time
+    size_t day_first, day_last;
+    this->get_day_event_range(std::min<uint16_t>(current_time_minutes / 1440, 6), day_first, day_last);
+    // Compare in seconds of the week so events within the same minute are ordered too
+    auto table = this->schedule_times_in_minutes_.begin();
+    const uint16_t *table_data = this->schedule_times_in_minutes_.data();
+    uint32_t current_week_second = current_time_minutes * 60u + current_second;
+    auto upper = std::upper_bound(table + day_first, table + day_last, current_week_second,
+                                  [this, table_data](uint32_t week_second, const uint16_t &entry_raw) {
+                                      return week_second < this->event_week_second_(&entry_raw - table_data, entry_raw);
+                                  });
+    size_t upper_index = upper - table;
     
-    for (size_t i = 0; i < this->schedule_times_in_minutes_.size(); i++) {
-        uint16_t entry_raw = this->schedule_times_in_minutes_[i];
-        
-        // Check for terminator (0xFFFF)
-        if (entry_raw == 0xFFFF) {
-            break;
-        }
-        
-        // Extract time value (mask off top 2 bits)
-        uint16_t entry_time = entry_raw & TIME_MASK;
-        
-        // If this entry's time has passed, it becomes the current event
-        if (entry_time <= current_time_minutes) {
-            current_index = static_cast<int16_t>(i);			
-        } else {
-            // Once we hit a future entry, stop searching
-            break;
-        }
-    }
-   
     // If no event has occurred yet this week, wrap around to the last event from previous week
-    if (current_index == -1) {
-        // Find the last valid entry in the schedule (before the 0xFFFF terminator)
-        for (size_t i = 0; i < this->schedule_times_in_minutes_.size(); i++) {
-            if (this->schedule_times_in_minutes_[i] == 0xFFFF) {
-                // Found terminator, the previous entry is the last event
-                if (i > 0) {
-                    current_index = static_cast<int16_t>(i - 1);
-                }
-                break;
-            }
-        }
+    if (upper_index == 0) {
+        return static_cast<int16_t>(this->schedule_event_count_ - 1);
     }
     
-    return current_index;
+    // The event before the first future event is the current event
+    // (the last event of an earlier day when nothing has happened yet today)
+    return static_cast<int16_t>(upper_index - 1);
 }
 
-bool Schedule::should_advance_to_next_event_(uint16_t current_time_minutes) {
-    uint16_t next_event_time = this->next_event_raw_ & TIME_MASK;
-    uint16_t current_event_time = this->current_event_raw_ & TIME_MASK;
-    
-    // Check if schedule wrapped around (next event is earlier in week than current)
-    bool wrapped_around = (next_event_time < current_event_time);
+bool Schedule::is_next_event_due_(uint32_t current_week_second) const {
+    // Work in seconds elapsed since the current event so the week wrap needs no special case
+    uint32_t current_event_time = this->event_week_second_(this->current_event_index_, this->current_event_raw_);
+    uint32_t next_event_time = this->event_week_second_(this->next_event_index_, this->next_event_raw_);
+    uint32_t span = (next_event_time + SECONDS_PER_WEEK - current_event_time) % SECONDS_PER_WEEK;
+    uint32_t elapsed = (current_week_second + SECONDS_PER_WEEK - current_event_time) % SECONDS_PER_WEEK;
     
-    // If wrapped around, check if current time has also wrapped (is before current event)
-    // This indicates we've crossed into the new week
-    bool time_has_wrapped = (current_time_minutes < current_event_time);
-    
-    // Debug logging every 60 seconds
-    static uint32_t last_debug_log = 0;
-    if (millis() - last_debug_log >= 60000) {
-        last_debug_log = millis();
-        ESP_LOGD(TAG, "Event check: current_time=%u, next_event=%u, current_event=%u, wrapped=%s, time_wrapped=%s", 
-                 current_time_minutes, next_event_time, current_event_time, 
-                 wrapped_around ? "Y" : "N", time_has_wrapped ? "Y" : "N");
+    if (span == 0) {
+        // A single event repeats after a full week, only the expired deadline can tell it is due;
+        // otherwise two events share a time and the second one is due together with the first
+        return this->next_event_index_ != this->current_event_index_ || this->event_timer_fired_;
+    }
+    return elapsed >= span;
+}
+
+int32_t Schedule::detect_clock_jump_() {
+    if (!this->last_tick_.time_valid) {
+        return 0;
     }
+    time_t timestamp = this->last_tick_.now.timestamp;
+    uint32_t now_ms = this->last_tick_.millis;
     
-    // Advance to next event if:
-    // 1. Current time has reached next event time AND
-    // 2. Either we haven't wrapped, OR we have wrapped AND time has also wrapped
-    return (current_time_minutes >= next_event_time && (!wrapped_around || time_has_wrapped));
+    int32_t jump_s = 0;
+    if (this->last_pass_timestamp_ != 0) {
+        // Wall time should advance with millis(); the difference is the clock correction
+        int64_t wall_elapsed = static_cast<int64_t>(timestamp - this->last_pass_timestamp_);
+        int64_t mono_elapsed = (now_ms - this->last_pass_ms_) / 1000;
+        int64_t drift = wall_elapsed - mono_elapsed;
+        if (drift > CLOCK_JUMP_THRESHOLD_S || drift < -CLOCK_JUMP_THRESHOLD_S) {
+            jump_s = static_cast<int32_t>(drift);
+        }
+    }
+    this->last_pass_timestamp_ = timestamp;
+    this->last_pass_ms_ = now_ms;
+    return jump_s;
+}
+
+void Schedule::resync_after_clock_jump_(int32_t jump_s) {
+    ESP_LOGW(TAG, "Clock jumped by %d s, re-seeking schedule", static_cast<int>(jump_s));
+    // Binary search within today's bucket instead of stepping one event per pass
+    this->initialize_schedule_operation_();
+    // Keep the reference so the same jump is not detected again on the next pass
+    this->last_pass_timestamp_ = this->last_tick_.now.timestamp;
+    this->last_pass_ms_ = this->last_tick_.millis;
 }
 
 void Schedule::advance_to_next_event_() {
@@ -455,7 +527,7 @@ void Schedule::advance_to_next_event_() {
     this->current_event_index_ = this->next_event_index_;
     
     // Check if we've reached the end of the schedule
-    if (this->schedule_times_in_minutes_[this->current_event_index_ + 1] == 0xFFFF) {
+    if (static_cast<size_t>(this->current_event_index_ + 1) >= this->schedule_event_count_) {
         // End of schedule reached, roll over to start
         ESP_LOGI(TAG, "End of schedule reached, rolling over to start of schedule");
         this->next_event_raw_ = this->schedule_times_in_minutes_[0];
@@ -468,12 +540,8 @@ void Schedule::advance_to_next_event_() {
 }
 
 void Schedule::check_and_advance_events_() {
-    // Get current time in minutes
-    auto now_time = this->time_->now();
-    uint16_t current_time_minutes = this->time_to_minutes_(now_time);
-    
     // Check if we should advance to next event
-    if (!this->should_advance_to_next_event_(current_time_minutes)) {
+    if (!this->is_next_event_due_(this->tick_week_second_())) {
         return;
     }
     
@@ -481,6 +549,531 @@ void Schedule::check_and_advance_events_() {
     this->advance_to_next_event_();
 }
 
+//==============================================================================
+// SCHEDULE QUERIES
+//==============================================================================
+
+ScheduleState Schedule::state_at(uint16_t week_minute, uint8_t second) const {
+    ScheduleState result;
+    if (!this->schedule_valid_ || this->schedule_event_count_ == 0 || week_minute >= 7 * 1440) {
+        return result;
+    }
+    
+    int16_t index = this->find_current_event_(week_minute, second);
+    result.valid = true;
+    result.event_index = index;
+    result.on = (this->schedule_times_in_minutes_[index] & SWITCH_STATE_BIT) != 0;
+    if (result.on) {
+        // ON events share their entry's data: state-based tables hold ON/OFF pairs, event-based singles
+        result.data_index = index / this->get_storage_multiplier();
+    }
+    return result;
+}
+
+size_t Schedule::next_events(ScheduleTransition *out, size_t max_count) const {
+    // Query the clock rather than the last tick, which may be up to a wakeup deadline old
+    if (this->time_ == nullptr) {
+        return 0;
+    }
+    ESPTime now = this->time_->now();
+    if (!now.is_valid()) {
+        return 0;
+    }
+    return this->next_events(ScheduleTickService::week_minute_of(now), now.second, out, max_count);
+}
+
+size_t Schedule::next_events(uint16_t week_minute, uint8_t second, ScheduleTransition *out, size_t max_count) const {
+    if (out == nullptr || !this->schedule_valid_ || this->schedule_event_count_ == 0 || week_minute >= 7 * 1440) {
+        return 0;
+    }
+    
+    uint32_t from = week_minute * 60u + second;
+    size_t count = this->schedule_event_count_;
+    size_t current = this->find_current_event_(from / 60, from % 60);
+    for (size_t i = 0; i < max_count; i++) {
+        size_t index = (current + 1 + i) % count;
+        uint16_t raw = this->schedule_times_in_minutes_[index];
+        uint32_t week_second = this->event_week_second_(index, raw);
+        
+        // Within one lap the delay is in (0, week]; every further lap adds a week
+        uint32_t delay = (week_second + SECONDS_PER_WEEK - from) % SECONDS_PER_WEEK;
+        if (delay == 0) {
+            delay = SECONDS_PER_WEEK;
+        }
+        
+        ScheduleTransition &transition = out[i];
+        transition.week_second = week_second;
+        transition.seconds_until = delay + static_cast<uint32_t>(i / count) * SECONDS_PER_WEEK;
+        transition.on = (raw & SWITCH_STATE_BIT) != 0;
+        transition.event_index = static_cast<int16_t>(index);
+        transition.data_index = transition.on ? static_cast<int16_t>(index / this->get_storage_multiplier()) : -1;
+    }
+    return max_count;
+}
+
+float Schedule::get_data_value(const char *label, int16_t data_index) const {
+    if (label == nullptr || data_index < 0) {
+        return NAN;
+    }
+    for (auto *sensor : this->data_sensors_) {
+        if (sensor->get_label() == label) {
+            size_t item_bytes = sensor->get_bytes_for_type(sensor->get_item_type());
+            if ((data_index + 1) * item_bytes > sensor->get_data_vector_size()) {
+                return NAN;
+            }
+            return sensor->get_sensor_value(data_index);
+        }
+    }
+    return NAN;
+}
+
+//==============================================================================
+// DAY EXCEPTIONS
+//==============================================================================
+
+uint16_t Schedule::exception_day_key_(uint8_t month, uint8_t day) {
+    // Days before each month in a leap year
+    static const uint16_t MONTH_OFFSET[12] = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0xFFFF;
+    }
+    uint16_t key = MONTH_OFFSET[month - 1] + day - 1;
+    return key < DAYS_PER_EXCEPTION_TABLE ? key : 0xFFFF;
+}
+
+void Schedule::add_day_exception(uint8_t month, uint8_t day, uint8_t until_month, uint8_t until_day,
+                                 DayException exception) {
+    uint16_t first = exception_day_key_(month, day);
+    uint16_t last = exception_day_key_(until_month, until_day);
+    if (first == 0xFFFF || last == 0xFFFF || exception > DAY_EXCEPTION_OFF) {
+        ESP_LOGW(TAG, "Ignoring invalid day exception %02u-%02u..%02u-%02u", month, day, until_month, until_day);
+        return;
+    }
+    if (this->day_exceptions_ == nullptr) {
+        this->day_exceptions_ = new uint8_t[DAYS_PER_EXCEPTION_TABLE]();  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    // A range ending before it starts wraps past the end of the year
+    for (uint16_t key = first;; key = (key + 1) % DAYS_PER_EXCEPTION_TABLE) {
+        this->day_exceptions_[key] = exception;
+        if (key == last) {
+            break;
+        }
+    }
+    // Look today up again on the next pass
+    this->exception_day_ = 0xFFFF;
+    this->request_wakeup_();
+}
+
+void Schedule::clear_day_exceptions() {
+    if (this->day_exceptions_ == nullptr) {
+        return;
+    }
+    std::memset(this->day_exceptions_, DAY_EXCEPTION_NONE, DAYS_PER_EXCEPTION_TABLE);
+    this->exception_day_ = 0xFFFF;
+    this->request_wakeup_();
+}
+
+DayException Schedule::get_day_exception(uint8_t month, uint8_t day) const {
+    uint16_t key = exception_day_key_(month, day);
+    if (this->day_exceptions_ == nullptr || key == 0xFFFF) {
+        return DAY_EXCEPTION_NONE;
+    }
+    return static_cast<DayException>(this->day_exceptions_[key]);
+}
+
+void Schedule::apply_day_exception_() {
+    if (this->day_exceptions_ == nullptr || !this->last_tick_.time_valid) {
+        return;
+    }
+    const ESPTime &now = this->last_tick_.now;
+    
+    // Only the first pass of a new date (or after a table edit) reads the table
+    uint16_t key = exception_day_key_(now.month, now.day_of_month);
+    if (key != this->exception_day_) {
+        this->exception_day_ = key;
+        DayException exception = key == 0xFFFF ? DAY_EXCEPTION_NONE : static_cast<DayException>(this->day_exceptions_[key]);
+        if (exception != this->active_day_exception_) {
+            ESP_LOGI(TAG, "Day exception for %02u-%02u: %u", now.month, now.day_of_month, exception);
+            this->active_day_exception_ = exception;
+            this->day_pattern_changed_ = true;
+        }
+    }
+    
+    // Run today as the substituted weekday
+    if (this->active_day_exception_ >= DAY_EXCEPTION_AS_MONDAY && this->active_day_exception_ <= DAY_EXCEPTION_AS_SUNDAY) {
+        this->last_tick_.week_minute = (this->active_day_exception_ - DAY_EXCEPTION_AS_MONDAY) * 1440 + now.hour * 60 + now.minute;
+    }
+}
+
+//==============================================================================
+// MULTI-WEEK ROTATION
+//==============================================================================
+
+uint8_t Schedule::current_rotation_week_() const {
+    if (!this->last_tick_.time_valid) {
+        return 0;
+    }
+    const ESPTime &now = this->last_tick_.now;
+    return (epoch_week(now.year, now.day_of_year) + this->rotation_week_offset_) % this->get_rotation_weeks();
+}
+
+void Schedule::apply_rotation_week_() {
+    if (!this->is_rotating_() || this->rotation_days_.empty() || !this->last_tick_.time_valid) {
+        return;
+    }
+    // The week can only change with the date
+    uint16_t day_of_year = this->last_tick_.now.day_of_year;
+    if (day_of_year == this->rotation_check_day_) {
+        return;
+    }
+    this->rotation_check_day_ = day_of_year;
+    uint8_t week = this->current_rotation_week_();
+    if (week == this->active_rotation_week_) {
+        return;
+    }
+    
+    // Swap the runtime table in place; nothing is parsed or written to flash
+    std::vector<uint16_t> table;
+    this->build_rotation_table_(week, table);
+    table.push_back(0xFFFF);
+    table.push_back(0xFFFF);
+    this->schedule_times_in_minutes_ = std::move(table);
+    this->index_schedule_table_();
+    this->active_rotation_week_ = week;
+    this->day_pattern_changed_ = true;
+    ESP_LOGI(TAG, "Rotation week %u active (%u events)", week, static_cast<unsigned>(this->schedule_event_count_));
+}
+
+bool Schedule::build_rotation_table_(uint8_t week, std::vector<uint16_t> &table) const {
+    table.clear();
+    if (static_cast<size_t>(week + 1) * 7 > this->rotation_days_.size()) {
+        return false;
+    }
+    for (uint8_t day = 0; day < 7; ++day) {
+        const uint16_t *pattern = &this->rotation_patterns_[this->rotation_pattern_offsets_[this->rotation_days_[week * 7 + day]]];
+        for (uint16_t i = 1; i <= pattern[0]; ++i) {
+            // Patterns are day-relative; restore the week minute and keep the state bit
+            table.push_back(((pattern[i] & TIME_MASK) + day * 1440) | (pattern[i] & SWITCH_STATE_BIT));
+        }
+    }
+    // A week without events in a rotation that has some elsewhere holds a single OFF event,
+    // so the schedule stays valid (switch OFF, no button events) instead of reporting empty
+    if (table.empty()) {
+        for (uint16_t offset : this->rotation_pattern_offsets_) {
+            if (this->rotation_patterns_[offset] != 0) {
+                table.push_back(0);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+uint16_t Schedule::intern_day_pattern_(const uint16_t *events, size_t count) {
+    // Reuse an identical pattern from any week
+    for (uint16_t p = 0; p < this->rotation_pattern_offsets_.size(); ++p) {
+        const uint16_t *pattern = &this->rotation_patterns_[this->rotation_pattern_offsets_[p]];
+        if (pattern[0] == count && std::equal(events, events + count, pattern + 1)) {
+            return p;
+        }
+    }
+    this->rotation_pattern_offsets_.push_back(static_cast<uint16_t>(this->rotation_patterns_.size()));
+    this->rotation_patterns_.push_back(static_cast<uint16_t>(count));
+    this->rotation_patterns_.insert(this->rotation_patterns_.end(), events, events + count);
+    return static_cast<uint16_t>(this->rotation_pattern_offsets_.size() - 1);
+}
+
+uint32_t Schedule::entity_ids_hash_() const {
+    // A single schedule keeps its original hash so existing devices do not refetch
+    uint32_t hash = fnv1_hash(this->ha_schedule_entity_id_);
+    for (const auto &rotation_entity_id : this->rotation_entity_ids_) {
+        hash = hash * 31 + fnv1_hash(rotation_entity_id);
+    }
+    return hash;
+}
+
+//==============================================================================
+// SOLAR EVENTS
+//==============================================================================
+
+void Schedule::parse_solar_anchors_(const JsonObjectConst &data, const std::vector<uint16_t> &work_buffer,
+                                    size_t first_word, uint8_t day) {
+    if (!this->stores_solar_()) {
+        return;
+    }
+    // "from_sun" applies to the first word of the entry, "to_sun" to the OFF word of a state-based entry
+    static const char *const SUN_KEYS[2] = {"from_sun", "to_sun"};
+    static const char *const OFFSET_KEYS[2] = {"from_offset", "to_offset"};
+    size_t words = std::min<size_t>(this->get_storage_multiplier(), 2);
+    for (size_t word = 0; word < words; ++word) {
+        const char *sun = data[SUN_KEYS[word]].as<const char*>();
+        if (sun == nullptr) {
+            continue;
+        }
+        bool sunset = strcmp(sun, "sunset") == 0;
+        if (!sunset && strcmp(sun, "sunrise") != 0) {
+            ESP_LOGW(TAG, "Unknown %s '%s'; using the fixed time", SUN_KEYS[word], sun);
+            continue;
+        }
+        int offset = data[OFFSET_KEYS[word]].as<int>();
+        offset = std::max<int>(-SOLAR_OFFSET_BIAS, std::min<int>(SOLAR_OFFSET_MASK - SOLAR_OFFSET_BIAS, offset));
+        
+        size_t position = first_word + word;
+        uint16_t stored = SOLAR_BIT | (work_buffer[position] & SWITCH_STATE_BIT) |
+                          (day << SOLAR_DAY_SHIFT) | (sunset ? SOLAR_SUNSET_BIT : 0) |
+                          static_cast<uint16_t>(offset + SOLAR_OFFSET_BIAS);
+        this->parsed_solar_.push_back({static_cast<uint16_t>(position), stored});
+    }
+}
+
+uint16_t Schedule::resolve_solar_anchor_(uint16_t stored, uint8_t today, uint16_t day_of_year,
+                                         int16_t utc_offset) const {
+    uint8_t day = std::min<uint8_t>((stored >> SOLAR_DAY_SHIFT) & 0x07, 6);
+    int offset = static_cast<int>(stored & SOLAR_OFFSET_MASK) - SOLAR_OFFSET_BIAS;
+    
+    // Solar noon stands in until the table and the date are known
+    int sun_minute = 720;
+    if (this->solar_table_ != nullptr && day_of_year != 0) {
+        // The entry's next occurrence: today or up to six days ahead
+        uint16_t date = day_of_year + (day + 7 - today) % 7;
+        if (date > SolarTable::DAYS) {
+            date -= 365;
+        }
+        sun_minute = this->solar_table_->sun_utc_minute(date, (stored & SOLAR_SUNSET_BIT) != 0) + utc_offset;
+        sun_minute = ((sun_minute % 1440) + 1440) % 1440;
+    }
+    int minute = std::max(0, std::min(1439, sun_minute + offset));
+    return static_cast<uint16_t>(day * 1440 + minute) | (stored & SWITCH_STATE_BIT);
+}
+
+void Schedule::apply_solar_day_() {
+    if (this->solar_anchors_.empty() || !this->last_tick_.time_valid) {
+        return;
+    }
+    const ESPTime &now = this->last_tick_.now;
+    if (now.day_of_year == this->solar_day_) {
+        return;
+    }
+    this->solar_day_ = now.day_of_year;
+    
+    uint8_t today = this->time_to_minutes_(now) / 1440;
+    int16_t utc_offset = utc_offset_minutes_(now);
+    size_t multiplier = this->get_storage_multiplier();
+    for (const auto &anchor : this->solar_anchors_) {
+        if (anchor.position < this->schedule_event_count_) {
+            this->schedule_times_in_minutes_[anchor.position] =
+                this->resolve_solar_anchor_(anchor.stored, today, now.day_of_year, utc_offset);
+        }
+    }
+    // An ON moved past its own OFF collapses the entry rather than wrapping it
+    if (multiplier == 2) {
+        for (const auto &anchor : this->solar_anchors_) {
+            size_t on = anchor.position & ~static_cast<size_t>(1);
+            if (on + 1 < this->schedule_event_count_ &&
+                (this->schedule_times_in_minutes_[on] & TIME_MASK) > (this->schedule_times_in_minutes_[on + 1] & TIME_MASK)) {
+                this->schedule_times_in_minutes_[on] = (this->schedule_times_in_minutes_[on + 1] & TIME_MASK) | SWITCH_STATE_BIT;
+            }
+        }
+    }
+    
+    // Only the resolved entries moved, and by a few minutes, so this is close to a single pass
+    this->sort_entries_incremental_();
+    this->index_schedule_table_();
+    this->day_pattern_changed_ = true;
+    ESP_LOGI(TAG, "Resolved %u solar times for day %u", static_cast<unsigned>(this->solar_anchors_.size()),
+             now.day_of_year);
+}
+
+void Schedule::sort_entries_incremental_() {
+    size_t multiplier = this->get_storage_multiplier();
+    size_t entries = this->schedule_event_count_ / multiplier;
+    const uint16_t *table = this->schedule_times_in_minutes_.data();
+    for (size_t entry = 1; entry < entries; ++entry) {
+        for (size_t j = entry; j > 0 && (table[(j - 1) * multiplier] & TIME_MASK) > (table[j * multiplier] & TIME_MASK); --j) {
+            this->swap_entries_(j - 1);
+        }
+    }
+}
+
+void Schedule::swap_entries_(size_t entry) {
+    size_t multiplier = this->get_storage_multiplier();
+    auto first = this->schedule_times_in_minutes_.begin() + entry * multiplier;
+    std::swap_ranges(first, first + multiplier, first + multiplier);
+    
+    for (DataSensor *sensor : this->data_sensors_) {
+        std::vector<uint8_t> &values = sensor->get_data_vector();
+        size_t bytes = sensor->get_bytes_for_type(sensor->get_item_type());
+        if ((entry + 2) * bytes <= values.size()) {
+            auto value = values.begin() + entry * bytes;
+            std::swap_ranges(value, value + bytes, value + bytes);
+        }
+    }
+    for (auto &anchor : this->solar_anchors_) {
+        size_t anchor_entry = anchor.position / multiplier;
+        if (anchor_entry == entry) {
+            anchor.position += multiplier;
+        } else if (anchor_entry == entry + 1) {
+            anchor.position -= multiplier;
+        }
+    }
+    this->on_entries_swapped_(entry);
+}
+
+int16_t Schedule::utc_offset_minutes_(const ESPTime &now) {
+    ESPTime utc = ESPTime::from_epoch_utc(now.timestamp);
+    int offset = (now.hour * 60 + now.minute) - (utc.hour * 60 + utc.minute);
+    // Local and UTC dates differ by at most one day; the year may roll over between them
+    if (now.year > utc.year || (now.year == utc.year && now.day_of_year > utc.day_of_year)) {
+        offset += 1440;
+    } else if (now.year < utc.year || (now.year == utc.year && now.day_of_year < utc.day_of_year)) {
+        offset -= 1440;
+    }
+    return static_cast<int16_t>(offset);
+}
+
+//==============================================================================
+// DST TRANSITIONS
+//==============================================================================
+
+void Schedule::apply_dst_rules_() {
+    if (!this->last_tick_.time_valid) {
+        return;
+    }
+    const ESPTime &now = this->last_tick_.now;
+    if (now.day_of_year != this->dst_check_day_) {
+        this->dst_check_day_ = now.day_of_year;
+        this->find_dst_transition_(now.timestamp);
+    }
+    // Repeated hour: stay just before the transition until the wall clock is past it again
+    if (this->dst_delta_s_ < 0 && now.timestamp >= this->dst_transition_ts_ &&
+        now.timestamp < this->dst_transition_ts_ - this->dst_delta_s_) {
+        this->last_tick_.week_minute = (this->last_tick_.week_minute / 1440) * 1440 + this->dst_hold_minute_;
+        this->last_tick_.now.second = 59;
+    }
+}
+
+void Schedule::find_dst_transition_(time_t timestamp) {
+    OffsetChange change = find_offset_change(timestamp, utc_offset_seconds_);
+    this->dst_transition_ts_ = change.timestamp;
+    this->dst_delta_s_ = change.delta_s;
+    if (change.delta_s == 0) {
+        return;
+    }
+    this->dst_hold_minute_ = change.hold_minute;
+    ESP_LOGI(TAG, "UTC offset changes by %+d min in %d s", static_cast<int>(this->dst_delta_s_ / 60),
+             static_cast<int>(change.timestamp - timestamp));
+}
+
+//==============================================================================
+// DEADLINE-DRIVEN WAKEUPS
+//==============================================================================
+
+void Schedule::arm_event_deadline_() {
+    if (!this->last_tick_.time_valid) {
+        return;
+    }
+    
+    uint32_t current_week_second = this->tick_week_second_();
+    // The expiry has been consumed by check_and_advance_events_() in this pass
+    this->event_timer_fired_ = false;
+    
+    if (this->is_next_event_due_(current_week_second)) {
+        // Still behind the schedule (e.g. after a clock jump) - keep catching up at the poll rate
+        this->arm_poll_timer_();
+        return;
+    }
+    
+    // Seconds until the next event, wrapping at the end of the week (a full week for a single event).
+    // A timer that fired a little early against the RTC lands here with a second or two to go.
+    uint32_t next_event_time = this->event_week_second_(this->next_event_index_, this->next_event_raw_);
+    uint32_t delay_s = (next_event_time + SECONDS_PER_WEEK - current_week_second) % SECONDS_PER_WEEK;
+    if (delay_s == 0) {
+        delay_s = SECONDS_PER_WEEK;
+    }
+    
+    // The delay is in wall-clock seconds; map it onto real seconds across a UTC offset change
+    if (this->dst_delta_s_ != 0) {
+        time_t now_ts = this->last_tick_.now.timestamp;
+        if (now_ts < this->dst_transition_ts_) {
+            uint32_t to_transition = this->dst_transition_ts_ - now_ts;
+            if (delay_s > to_transition) {
+                // Events inside a skipped hour fire at the transition
+                int64_t real_delay = static_cast<int64_t>(delay_s) - this->dst_delta_s_;
+                delay_s = static_cast<uint32_t>(std::max<int64_t>(real_delay, to_transition));
+            }
+        } else if (now_ts < this->dst_transition_ts_ - this->dst_delta_s_) {
+            // Held in a repeated hour: the schedule clock resumes when the hour is over
+            delay_s += this->dst_transition_ts_ - this->dst_delta_s_ - now_ts;
+        }
+    }
+    
+    uint32_t max_delay_s = WAKEUP_MAX_DEADLINE_S;
+    // While disconnected, also wake for the reconnect check in check_prerequisites_()
+    if (!this->ha_connected_) {
+        max_delay_s = std::min<uint32_t>(max_delay_s, this->ha_connected_once_ ? 60 : 5);
+    }
+    // Day exceptions and rotation weeks are looked up per date, so wake at midnight to switch pattern
+    if (this->day_exceptions_ != nullptr || this->is_rotating_()) {
+        const ESPTime &now = this->last_tick_.now;
+        uint32_t seconds_to_midnight = 86400 - (now.hour * 3600u + now.minute * 60u + now.second);
+        max_delay_s = std::min<uint32_t>(max_delay_s, seconds_to_midnight);
+    }
+    this->arm_lead_triggers_(delay_s);
+    
+    this->event_timer_is_deadline_ = delay_s <= max_delay_s;
+    if (!this->event_timer_is_deadline_) {
+        delay_s = max_delay_s;
+    }
+    
+    this->arm_timer_(&this->event_timer_, delay_s);
+    ESP_LOGV(TAG, "Next wakeup in %u s (next event %s)", delay_s,
+             this->format_event_time_(this->next_event_raw_ & TIME_MASK, this->event_second_(this->next_event_index_)).c_str());
+}
+
+void Schedule::add_lead_trigger(ScheduleLeadTrigger *trigger) {
+    trigger->timer_.callback = [this, trigger]() { this->fire_lead_trigger_(trigger); };
+    this->lead_triggers_.push_back(trigger);
+}
+
+void Schedule::arm_lead_triggers_(uint32_t delay_s) {
+    if (this->lead_triggers_.empty()) {
+        return;
+    }
+    bool enabled = this->lead_triggers_enabled_();
+    bool next_on = (this->next_event_raw_ & SWITCH_STATE_BIT) != 0;
+    time_t target_ts = this->last_tick_.now.timestamp + delay_s;
+    for (auto *trigger : this->lead_triggers_) {
+        bool wanted = enabled &&
+                      (trigger->filter_ == LEAD_TRIGGER_ANY || (trigger->filter_ == LEAD_TRIGGER_ON) == next_on);
+        // A later pass re-derives the same event within a few seconds (RTC drift), so it is not fired twice
+        bool fired = trigger->fired_for_ts_ != 0 && std::abs(static_cast<int64_t>(target_ts - trigger->fired_for_ts_)) < 60;
+        if (!wanted || fired) {
+            this->cancel_timer_(&trigger->timer_);
+            continue;
+        }
+        trigger->target_ts_ = target_ts;
+        if (delay_s <= trigger->lead_s_) {
+            // The event became next inside the lead window: fire now rather than not at all
+            this->cancel_timer_(&trigger->timer_);
+            this->fire_lead_trigger_(trigger);
+        } else {
+            this->arm_timer_(&trigger->timer_, delay_s - trigger->lead_s_);
+        }
+    }
+}
+
+void Schedule::fire_lead_trigger_(ScheduleLeadTrigger *trigger) {
+    // Timers armed before an error or manual mode are dropped when they expire
+    if (!this->lead_triggers_enabled_()) {
+        return;
+    }
+    trigger->fired_for_ts_ = trigger->target_ts_;
+    ESP_LOGD(TAG, "Lead trigger: next event %s, %us ahead",
+             this->format_event_time_(this->next_event_raw_ & TIME_MASK, this->event_second_(this->next_event_index_)).c_str(),
+             static_cast<unsigned>(trigger->lead_s_));
+    trigger->trigger();
+}
+
 //==============================================================================
 // UI UPDATE METHODS
 //==============================================================================
@@ -535,12 +1128,15 @@ uint16_t Schedule::get_current_week_minutes_() {
     }
     
     // Calculate current time in minutes from start of week (Monday = 0)
-    // ESPHome: 1=Sunday, 2=Monday, ..., 7=Saturday
-    // We need: Monday=0, ..., Sunday=6
-    uint8_t day_of_week = (now.day_of_week + 5) % 7;  // Convert to Monday=0
-    uint16_t current_time_minutes = (day_of_week * 1440) + (now.hour * 60) + now.minute;
-    
-    return current_time_minutes;
+    return this->time_to_minutes_(now);
+}
+
+uint8_t Schedule::timeToSeconds_(const char* time_str) {
+    int h = 0, m = 0, s = 0;
+    if (sscanf(time_str, "%d:%d:%d", &h, &m, &s) == 3) {
+        return s;
+    }
+    return 0;
 }
 
 bool Schedule::isValidTime_(const JsonVariantConst &time_obj) const {
@@ -555,7 +1151,7 @@ bool Schedule::isValidTime_(const JsonVariantConst &time_obj) const {
     return false;
 }
 
-std::string Schedule::format_event_time_(uint16_t time_minutes) {
+std::string Schedule::format_event_time_(uint16_t time_minutes, uint8_t second) {
     uint8_t day = time_minutes / 1440;  // 1440 minutes in a day
 	std::string day_str;
 	switch(day) {
@@ -573,7 +1169,11 @@ std::string Schedule::format_event_time_(uint16_t time_minutes) {
     uint8_t minute = minutes_in_day % 60;
     
     char buffer[16];
-    snprintf(buffer, sizeof(buffer), "%s:%02u:%02u", day_str.c_str(), hour, minute);
+    if (this->second_resolution_) {
+        snprintf(buffer, sizeof(buffer), "%s:%02u:%02u:%02u", day_str.c_str(), hour, minute, second);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%s:%02u:%02u", day_str.c_str(), hour, minute);
+    }
     return std::string(buffer);
 }
 
@@ -589,6 +1189,8 @@ void Schedule::create_schedule_preference() {
         return;
     }
     sched_array_pref_->create_preference(this->get_object_id_hash());
+    // Defer the flash sync so one update costs a single sync for all records
+    sched_array_pref_->set_sync_service(this->tick_service_);
     ESP_LOGV(TAG, "Preference created successfully");
 }
 
@@ -600,69 +1202,58 @@ void Schedule::load_schedule_from_pref_() {
         this->schedule_valid_ = false;
         return;
     } 
-    // Create temporary buffer to load data
-    std::vector<uint16_t> temp_buffer(this->schedule_max_size_);
+    std::vector<uint16_t> temp_buffer;
     // Load data into the array preference
     this->sched_array_pref_->load();
-    //
-    bool ok = this->sched_array_pref_->is_valid();
-    //bool ok = false;
     ESP_LOGV(TAG, "Schedule preference load completed");
-   if (!ok) {
-       ESP_LOGW(TAG, "Schedule preference data is not valid");
-       this->schedule_empty_ = true;
-    }
-    else {
-        uint8_t *buf = this->sched_array_pref_->data();
-        std::memcpy(temp_buffer.data(), buf, this->sched_array_pref_->size());
-        // Check for terminator [0xFFFF, 0xFFFF] - used by both state-based and event-based
-        for (size_t i = 0; i < this->schedule_max_size_; i += 2) {
-            if (temp_buffer[i] == 0xFFFF && temp_buffer[i + 1] == 0xFFFF) {
-                ESP_LOGI(TAG, "Found terminator at index %u; actual schedule size is %u entries", 
-                         static_cast<unsigned>(i / 2), static_cast<unsigned>(i));
-                // Schedule is empty if terminator is at the very first position
-                this->schedule_empty_ = (i == 0);
-                ok=true;
-                break;
-            }
-            if (i == this->schedule_max_size_ - 2) {
-                ESP_LOGW(TAG, "No terminator found");
-                ok=false;
+    bool ok = this->sched_array_pref_->is_valid() &&
+              this->read_schedule_record_(this->sched_array_pref_->data(), this->sched_array_pref_->size(),
+                                          this->data_entries_(), false, temp_buffer);
+    bool migrated = false;
+    if (!ok) {
+        // Saved with another size or before the storage header existed: migrate instead of refetching
+        std::vector<uint8_t> previous;
+        if (this->load_previous_record_(previous)) {
+            size_t entries = this->storage_footprint_valid_ ? this->storage_footprint_.entries : this->data_entries_();
+            ok = this->read_schedule_record_(previous.data(), previous.size(), entries, true, temp_buffer);
+            migrated = ok;
+            if (ok) {
+                ESP_LOGI(TAG, "Migrating stored schedule from a %u byte record to %u bytes",
+                         static_cast<unsigned>(previous.size()), static_cast<unsigned>(this->sched_array_pref_->size()));
             }
         }
     }
-        
     if (ok) {
-        // Copy all data from temp_buffer into schedule_times_in_minutes_
-        this->schedule_times_in_minutes_.clear();
-        this->schedule_times_in_minutes_.reserve(this->schedule_max_size_);
-        
-        // Copy ALL values - don't stop at terminator during load
-        for (size_t i = 0; i < this->schedule_max_size_; ++i) {
-            this->schedule_times_in_minutes_.push_back(temp_buffer[i]);
-        }
-        //this->schedule_empty_ = false;
+        // Schedule is empty if the terminator is at the very first position
+        this->schedule_empty_ = (temp_buffer.size() <= 2);
+    } else {
+        ESP_LOGW(TAG, "Schedule preference data is not valid");
+        this->schedule_empty_ = true;
+    }
+        
+    if (ok) {
+        // Store the exact-length table (events + terminator)
+        this->schedule_times_in_minutes_ = std::move(temp_buffer);
+        this->index_schedule_table_();
         this->schedule_valid_ = true;   
         ESP_LOGI(TAG, "Loaded %u uint16_t values from preferences", 
                  static_cast<unsigned>(this->schedule_times_in_minutes_.size()));
+        if (migrated) {
+            // Rewrite in the current layout, replacing the previous record under the same key
+            this->save_schedule_to_pref_();
+        }
         
     } else {
         // No stored data: use factory defaults and persist them
         this->schedule_times_in_minutes_ = this->factory_reset_values_;
+        this->event_seconds_.clear();
+        this->index_schedule_table_();
         this->schedule_empty_ = true;
-        if (this->schedule_times_in_minutes_.size() > this->schedule_max_size_) {
-            this->schedule_times_in_minutes_.resize(this->schedule_max_size_);
-        }
-       // Fill remaining entries with zeros if needed
-       while (this->schedule_times_in_minutes_.size() < this->schedule_max_size_) {
-           this->schedule_times_in_minutes_.push_back(0);
-        }
         // save defaults to preferences
-        uint8_t *buf = sched_array_pref_->data();
-        std::memcpy(buf, this->schedule_times_in_minutes_.data(), sched_array_pref_->size());
-        sched_array_pref_->save();
+        this->save_schedule_to_pref_();
         ESP_LOGI(TAG, "No stored values; using factory defaults and saving them");
     }
+    this->save_storage_footprint_();
     // Debug log values
     log_state_flags_();
     for (size_t i = 0; i < this->schedule_times_in_minutes_.size(); ++i) {
@@ -679,10 +1270,537 @@ void Schedule::save_schedule_to_pref_() {
         schedule_times_in_minutes_.resize(schedule_max_size_);
         ESP_LOGW(TAG, "Input schedule size exceeds max size. Truncating to max size of %zu entries.", schedule_max_size_);
     }
-    uint8_t *buf = sched_array_pref_->data();
-    std::memcpy(buf, this->schedule_times_in_minutes_.data(), this->sched_array_pref_->size());
-    this->sched_array_pref_->save();
-    ESP_LOGV(TAG, "Schedule times saved to preferences using %u bytes.", this->sched_array_pref_->size());
+    // Encode according to the storage type and zero the unused tail of the fixed-size preference
+    uint8_t *buf = this->table_region_();
+    size_t capacity = this->table_region_size_();
+    size_t used_bytes = this->encode_schedule_storage_(buf, capacity);
+    // A grown schedule may outgrow the record: add a chunk at a time, up to the schedule_size_limit record
+    while (used_bytes == 0 && this->sched_array_pref_->grow()) {
+        buf = this->table_region_();
+        capacity = this->table_region_size_();
+        used_bytes = this->encode_schedule_storage_(buf, capacity);
+    }
+    if (used_bytes == 0) {
+        ESP_LOGE(TAG, "Schedule does not fit in %u bytes of storage; not saved", 
+                 static_cast<unsigned>(capacity));
+        this->send_ha_notification_("Schedule for " + this->ha_schedule_entity_id_ + 
+                                    " does not fit in the configured storage and was not saved. Consider increasing schedule_size_limit.",
+                                    "Schedule Warning");
+        return;
+    }
+    std::memset(buf + used_bytes, 0, capacity - used_bytes);
+    uint8_t *record = this->sched_array_pref_->data();
+    if (this->combined_storage_) {
+        // Header and data columns go into the same record, so one save covers the whole update
+        uint8_t *header = record + STORAGE_HEADER_BYTES;
+        const uint16_t magic = COMBINED_RECORD_MAGIC;
+        std::memcpy(header, &magic, sizeof(magic));
+        header[2] = COMBINED_RECORD_VERSION;
+        header[3] = static_cast<uint8_t>(this->data_sensors_.size());
+        this->write_combined_columns_();
+    }
+    write_storage_header(record, this->sched_array_pref_->size(), this->storage_layout_(),
+                         static_cast<uint16_t>(this->schedule_times_in_minutes_.size()),
+                         static_cast<uint16_t>(used_bytes));
+    for (auto *sensor : this->data_sensors_) {
+        sensor->stage_data_to_pref();
+    }
+    uint32_t writes = this->get_pref_write_count();
+    this->write_generation_();
+    if (this->get_pref_write_count() == writes) {
+        ESP_LOGD(TAG, "Schedule unchanged; preferences not rewritten");
+        return;
+    }
+    ESP_LOGV(TAG, "Schedule saved to slot %u using %u of %u bytes.", this->sched_array_pref_->get_slot(),
+             static_cast<unsigned>(used_bytes), static_cast<unsigned>(this->sched_array_pref_->size()));
+}
+
+std::vector<ArrayPreferenceBase *> Schedule::generation_records_() {
+    std::vector<ArrayPreferenceBase *> records{this->sched_array_pref_};
+    if (!this->combined_storage_) {
+        for (auto *sensor : this->data_sensors_) {
+            if (sensor->get_array_preference() != nullptr) {
+                records.push_back(sensor->get_array_preference());
+            }
+        }
+    }
+    return records;
+}
+
+void Schedule::write_generation_() {
+    auto records = this->generation_records_();
+    bool changed = std::any_of(records.begin(), records.end(),
+                               [](ArrayPreferenceBase *record) { return !record->matches_committed(); });
+    if (!changed) {
+        // The committed slot already holds this content; the saves below only count as skipped
+        for (auto *record : records) {
+            record->save();
+        }
+        return;
+    }
+    // Every record of the update goes to the other slot, so the committed generation stays whole
+    for (auto *record : records) {
+        record->begin_update();
+        record->save();
+    }
+    if (this->slot_commit_pending_) {
+        return;
+    }
+    // The pointer naming the new slot is written only once the records above are on flash
+    this->slot_commit_pending_ = true;
+    if (this->tick_service_ != nullptr) {
+        this->tick_service_->after_pref_sync([this]() { this->commit_slot_pointer_(); });
+    } else {
+        this->commit_slot_pointer_();
+        global_preferences->sync();
+    }
+}
+
+void Schedule::commit_slot_pointer_() {
+    SlotPointer pointer{this->slot_generation_ + 1, ~(this->slot_generation_ + 1)};
+    this->slot_pointer_pref_.save(&pointer);
+    this->slot_generation_ = pointer.generation;
+    this->slot_commit_pending_ = false;
+    for (auto *record : this->generation_records_()) {
+        record->commit_slot();
+    }
+    // Sizes of the generation just committed, in case the update grew the records
+    this->save_storage_footprint_();
+    ESP_LOGD(TAG, "Committed generation %u in slot %u", static_cast<unsigned>(this->slot_generation_),
+             static_cast<unsigned>(this->slot_generation_ & 1));
+}
+
+void Schedule::load_slot_pointer_() {
+    SlotPointer pointer{};
+    // No pointer yet (first boot, or records saved before slots existed): generation 0 in slot 0
+    this->slot_generation_ = this->slot_pointer_pref_.load(&pointer) && pointer.check == ~pointer.generation ? pointer.generation : 0;
+    uint8_t slot = this->slot_generation_ & 1;
+    if (this->sched_array_pref_ != nullptr) {
+        this->sched_array_pref_->set_committed_slot(slot);
+    }
+    for (auto *sensor : this->data_sensors_) {
+        if (sensor->get_array_preference() != nullptr) {
+            sensor->get_array_preference()->set_committed_slot(slot);
+        }
+    }
+    ESP_LOGD(TAG, "Loading generation %u from slot %u", static_cast<unsigned>(this->slot_generation_), slot);
+}
+
+size_t Schedule::combined_columns_bytes_(size_t data_entries) const {
+    size_t columns = 0;
+    for (const auto *sensor : this->data_sensors_) {
+        columns += data_entries * sensor->get_bytes_for_type(sensor->get_item_type());
+    }
+    return columns;
+}
+
+size_t Schedule::table_region_size_() const {
+    size_t size = this->sched_array_pref_->size();
+    size_t reserved = STORAGE_HEADER_BYTES;
+    if (this->combined_storage_) {
+        reserved += COMBINED_HEADER_BYTES + this->combined_columns_bytes_(this->data_entries_());
+    }
+    return size > reserved ? size - reserved : 0;
+}
+
+uint8_t *Schedule::table_region_() {
+    return this->sched_array_pref_->data() + STORAGE_HEADER_BYTES + (this->combined_storage_ ? COMBINED_HEADER_BYTES : 0);
+}
+
+bool Schedule::check_combined_header_(const uint8_t *header) const {
+    uint16_t magic;
+    std::memcpy(&magic, header, sizeof(magic));
+    return magic == COMBINED_RECORD_MAGIC && header[2] == COMBINED_RECORD_VERSION &&
+           header[3] == this->data_sensors_.size();
+}
+
+void Schedule::write_combined_columns_() {
+    // Columns follow the table region in sensor order, each the size of the sensor's data vector
+    uint8_t *column = this->table_region_() + this->table_region_size_();
+    for (auto *sensor : this->data_sensors_) {
+        auto &data = sensor->get_data_vector();
+        std::memcpy(column, data.data(), data.size());
+        column += data.size();
+    }
+}
+
+void Schedule::read_combined_columns_(const uint8_t *columns, size_t data_entries) {
+    for (auto *sensor : this->data_sensors_) {
+        auto &data = sensor->get_data_vector();
+        size_t stored = data_entries * sensor->get_bytes_for_type(sensor->get_item_type());
+        size_t copied = std::min(stored, data.size());
+        std::memcpy(data.data(), columns, copied);
+        std::fill(data.begin() + copied, data.end(), 0);
+        columns += stored;
+    }
+}
+
+size_t Schedule::data_entries_() const {
+    return this->data_sensors_.empty() ? 0 : this->data_sensors_.front()->get_max_schedule_data_entries();
+}
+
+uint8_t Schedule::storage_layout_() const {
+    uint8_t layout = STORAGE_LAYOUT_TABLE;
+    if (this->is_rotating_()) {
+        layout = STORAGE_LAYOUT_ROTATION;
+    } else if (this->second_resolution_) {
+        layout = STORAGE_LAYOUT_WIDE;
+    } else if (this->compressed_storage_) {
+        layout = STORAGE_LAYOUT_COMPRESSED;
+    }
+    return this->get_storage_multiplier() == 1 ? (layout | STORAGE_LAYOUT_EVENT_FLAG) : layout;
+}
+
+bool Schedule::read_schedule_record_(const uint8_t *record, size_t size, size_t data_entries, bool legacy,
+                                     std::vector<uint16_t> &table) {
+    StorageHeader header{};
+    StorageHeaderStatus status = check_storage_header(record, size, this->storage_layout_(), header);
+    bool has_header = status != STORAGE_HEADER_MISSING;
+    if (has_header) {
+        const char *problem = nullptr;
+        if (status == STORAGE_HEADER_BAD_VERSION) {
+            problem = "has an unknown format version";
+        } else if (status == STORAGE_HEADER_BAD_LAYOUT) {
+            problem = "uses another storage type";
+        } else if (status == STORAGE_HEADER_BAD_CRC) {
+            problem = "failed its CRC check";
+        }
+        if (problem != nullptr && !legacy) {
+            ESP_LOGW(TAG, "Stored schedule %s", problem);
+            return false;
+        }
+        // A headerless record may start with the magic by chance; it is then read as legacy below
+        has_header = problem == nullptr;
+    }
+    if (has_header) {
+        record += STORAGE_HEADER_BYTES;
+        size -= STORAGE_HEADER_BYTES;
+    } else if (!legacy) {
+        ESP_LOGW(TAG, "Stored schedule has no storage header");
+        return false;
+    }
+    
+    const uint8_t *columns = nullptr;
+    if (this->combined_storage_) {
+        size_t reserved = COMBINED_HEADER_BYTES + this->combined_columns_bytes_(data_entries);
+        if (size <= reserved || !this->check_combined_header_(record)) {
+            ESP_LOGW(TAG, "Combined schedule record has an unknown layout");
+            return false;
+        }
+        columns = record + size - this->combined_columns_bytes_(data_entries);
+        record += COMBINED_HEADER_BYTES;
+        size -= reserved;
+    }
+    
+    bool ok;
+    if (has_header) {
+        // Exact length: the decoder checks the terminator where the header says it is
+        if (header.payload_bytes > size) {
+            ESP_LOGW(TAG, "Stored schedule payload of %u bytes exceeds its record", header.payload_bytes);
+            return false;
+        }
+        this->stored_entry_count_ = header.entry_count;
+        ok = this->decode_schedule_storage_(record, header.payload_bytes, table);
+        this->stored_entry_count_ = 0;
+    } else {
+        ESP_LOGI(TAG, "Reading schedule saved before the storage header");
+        ok = this->decode_schedule_storage_(record, size, table);
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "No terminator found");
+        return false;
+    }
+    // The data columns come from the same record
+    if (columns != nullptr) {
+        this->read_combined_columns_(columns, data_entries);
+    }
+    return true;
+}
+
+bool Schedule::load_previous_record_(std::vector<uint8_t> &record) {
+    size_t size = this->sched_array_pref_->size();
+    // Without a footprint the record predates it: same configuration, but no storage header
+    size_t stored_size = this->storage_footprint_valid_ ? this->storage_footprint_.record_bytes
+                                                        : size - STORAGE_HEADER_BYTES;
+    bool chunked = this->stored_records_chunked();
+    if (stored_size == size && chunked) {
+        // Nothing else was stored: the record already loaded is the only candidate
+        return false;
+    }
+    return this->sched_array_pref_->load_resized(stored_size, record, chunked);
+}
+
+void Schedule::load_storage_footprint_() {
+    this->storage_footprint_valid_ = this->storage_footprint_pref_.load(&this->storage_footprint_) &&
+                                     (this->storage_footprint_.version == FOOTPRINT_VERSION_BLOB ||
+                                      this->storage_footprint_.version == FOOTPRINT_VERSION_CHUNKED);
+    if (this->storage_footprint_valid_) {
+        ESP_LOGV(TAG, "Stored schedule record: %u bytes, %u entries, %s",
+                 static_cast<unsigned>(this->storage_footprint_.record_bytes), this->storage_footprint_.entries,
+                 this->stored_records_chunked() ? "chunked" : "single blob");
+    }
+}
+
+void Schedule::save_storage_footprint_() {
+    StorageFootprint current{};
+    current.record_bytes = this->sched_array_pref_->size();
+    current.entries = static_cast<uint16_t>(this->schedule_max_entries_);
+    current.version = FOOTPRINT_VERSION_CHUNKED;
+    if (this->storage_footprint_valid_ && std::memcmp(&current, &this->storage_footprint_, sizeof(current)) == 0) {
+        return;
+    }
+    this->storage_footprint_pref_.save(&current);
+    this->storage_footprint_ = current;
+    this->storage_footprint_valid_ = true;
+}
+
+size_t Schedule::get_stored_data_entries() const {
+    if (!this->storage_footprint_valid_) {
+        // Saved before the footprint existed: same entries, as a single blob
+        return this->data_entries_();
+    }
+    if (this->stored_records_chunked() && this->storage_footprint_.entries == this->data_entries_()) {
+        return 0;
+    }
+    return this->storage_footprint_.entries;
+}
+
+void Schedule::grow_schedule_capacity_(size_t entries) {
+    if (entries <= this->schedule_max_entries_) {
+        return;
+    }
+    ESP_LOGI(TAG, "Growing schedule capacity from %u to %u entries", static_cast<unsigned>(this->schedule_max_entries_),
+             static_cast<unsigned>(entries));
+    this->set_max_schedule_entries(entries);
+    for (auto *sensor : this->data_sensors_) {
+        sensor->resize_entries(entries);
+    }
+}
+
+void Schedule::publish_pref_write_counts_() {
+    if (this->pref_writes_sensor_ != nullptr) {
+        this->pref_writes_sensor_->publish_state(this->get_pref_write_count());
+    }
+    if (this->pref_writes_skipped_sensor_ != nullptr) {
+        this->pref_writes_skipped_sensor_->publish_state(this->get_skipped_pref_write_count());
+    }
+}
+
+uint32_t Schedule::get_pref_write_count() const {
+    uint32_t count = this->sched_array_pref_ != nullptr ? this->sched_array_pref_->get_write_count() : 0;
+    for (const auto *sensor : this->data_sensors_) {
+        if (sensor->get_array_preference() != nullptr) {
+            count += sensor->get_array_preference()->get_write_count();
+        }
+    }
+    return count;
+}
+
+uint32_t Schedule::get_skipped_pref_write_count() const {
+    uint32_t count = this->sched_array_pref_ != nullptr ? this->sched_array_pref_->get_skipped_write_count() : 0;
+    for (const auto *sensor : this->data_sensors_) {
+        if (sensor->get_array_preference() != nullptr) {
+            count += sensor->get_array_preference()->get_skipped_write_count();
+        }
+    }
+    return count;
+}
+
+size_t Schedule::encode_schedule_storage_(uint8_t *buf, size_t capacity) {
+    if (this->is_rotating_()) {
+        // Rotation: [marker, weeks, pattern count, day -> pattern (weeks x 7), patterns..., terminator]
+        size_t words = 3 + this->rotation_days_.size() + this->rotation_patterns_.size() + 2;
+        if (words * sizeof(uint16_t) > capacity) {
+            return 0;
+        }
+        const uint16_t header[3] = {ROTATION_STORAGE_MARKER, static_cast<uint16_t>(this->get_rotation_weeks()),
+                                    static_cast<uint16_t>(this->rotation_pattern_offsets_.size())};
+        const uint16_t terminator[2] = {0xFFFF, 0xFFFF};
+        uint8_t *out = buf;
+        std::memcpy(out, header, sizeof(header));
+        out += sizeof(header);
+        std::memcpy(out, this->rotation_days_.data(), this->rotation_days_.size() * sizeof(uint16_t));
+        out += this->rotation_days_.size() * sizeof(uint16_t);
+        std::memcpy(out, this->rotation_patterns_.data(), this->rotation_patterns_.size() * sizeof(uint16_t));
+        out += this->rotation_patterns_.size() * sizeof(uint16_t);
+        std::memcpy(out, terminator, sizeof(terminator));
+        return words * sizeof(uint16_t);
+    }
+    
+    if (this->second_resolution_) {
+        // Wide encoding: uint32_t seconds-of-week plus flag bits, single-word terminator
+        size_t used_bytes = (this->schedule_event_count_ + 1) * sizeof(uint32_t);
+        if (used_bytes > capacity) {
+            return 0;
+        }
+        for (size_t i = 0; i < this->schedule_event_count_; ++i) {
+            uint16_t event_raw = this->schedule_times_in_minutes_[i];
+            uint32_t word = this->event_week_second_(i, event_raw);
+            if (event_raw & SWITCH_STATE_BIT) {
+                word |= WIDE_STATE_BIT;
+            }
+            std::memcpy(buf + i * sizeof(uint32_t), &word, sizeof(word));
+        }
+        std::memcpy(buf + this->schedule_event_count_ * sizeof(uint32_t), &WIDE_TERMINATOR, sizeof(uint32_t));
+        return used_bytes;
+    }
+    
+    if (this->compressed_storage_) {
+        return this->encode_compressed_table_(buf, capacity);
+    }
+    
+    // Raw exact-length table (events + terminator)
+    size_t used_bytes = this->schedule_times_in_minutes_.size() * sizeof(uint16_t);
+    if (used_bytes > capacity) {
+        return 0;
+    }
+    std::memcpy(buf, this->schedule_times_in_minutes_.data(), used_bytes);
+    // Solar times are stored as their anchor, not today's resolved minute
+    for (const auto &anchor : this->solar_anchors_) {
+        std::memcpy(buf + anchor.position * sizeof(uint16_t), &anchor.stored, sizeof(uint16_t));
+    }
+    return used_bytes;
+}
+
+bool Schedule::decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) {
+    if (this->is_rotating_()) {
+        size_t words = size / sizeof(uint16_t);
+        std::vector<uint16_t> stored(words);
+        std::memcpy(stored.data(), buf, words * sizeof(uint16_t));
+        const uint16_t *in = stored.data();
+        size_t weeks = this->get_rotation_weeks();
+        size_t day_words = weeks * 7;
+        if (words < 3 + day_words + 2 || in[0] != ROTATION_STORAGE_MARKER || in[1] != weeks) {
+            ESP_LOGW(TAG, "Stored schedule is not a %u-week rotation", static_cast<unsigned>(weeks));
+            return false;
+        }
+        uint16_t pattern_count = in[2];
+        
+        // Walk the [count, events...] runs to find where each pattern starts
+        std::vector<uint16_t> offsets;
+        size_t pos = 3 + day_words;
+        size_t patterns_start = pos;
+        for (uint16_t p = 0; p < pattern_count; ++p) {
+            if (pos >= words || pos + 1 + in[pos] > words) {
+                return false;
+            }
+            offsets.push_back(static_cast<uint16_t>(pos - patterns_start));
+            pos += 1 + in[pos];
+        }
+        if (pos + 2 > words || in[pos] != 0xFFFF || in[pos + 1] != 0xFFFF) {
+            ESP_LOGW(TAG, "No terminator found after rotation patterns");
+            return false;
+        }
+        for (size_t d = 0; d < day_words; ++d) {
+            if (in[3 + d] >= pattern_count) {
+                return false;
+            }
+        }
+        
+        this->rotation_days_.assign(in + 3, in + 3 + day_words);
+        this->rotation_patterns_.assign(in + patterns_start, in + pos);
+        this->rotation_pattern_offsets_ = std::move(offsets);
+        this->active_rotation_week_ = this->current_rotation_week_();
+        this->rotation_check_day_ = this->last_tick_.time_valid ? this->last_tick_.now.day_of_year : 0xFFFF;
+        this->build_rotation_table_(this->active_rotation_week_, table);
+        table.push_back(0xFFFF);
+        table.push_back(0xFFFF);
+        ESP_LOGI(TAG, "Loaded %u-week rotation with %u distinct day patterns", 
+                 static_cast<unsigned>(weeks), pattern_count);
+        return true;
+    }
+    
+    if (this->second_resolution_) {
+        // Wide encoding: split each word back into the minute table and the seconds table
+        size_t max_events = this->schedule_max_size_ - 2;
+        size_t stored_words = size / sizeof(uint32_t);
+        table.clear();
+        this->event_seconds_.clear();
+        for (size_t i = 0; i < stored_words && i <= max_events; ++i) {
+            uint32_t word;
+            std::memcpy(&word, buf + i * sizeof(uint32_t), sizeof(word));
+            if (word == WIDE_TERMINATOR) {
+                table.push_back(0xFFFF);
+                table.push_back(0xFFFF);
+                ESP_LOGI(TAG, "Found terminator at index %u (second resolution)", static_cast<unsigned>(i));
+                return true;
+            }
+            uint32_t week_second = word & WIDE_TIME_MASK;
+            if (week_second >= SECONDS_PER_WEEK) {
+                break;
+            }
+            uint16_t event_raw = week_second / 60;
+            if (word & WIDE_STATE_BIT) {
+                event_raw |= SWITCH_STATE_BIT;
+            }
+            table.push_back(event_raw);
+            this->event_seconds_.push_back(week_second % 60);
+        }
+        this->event_seconds_.clear();
+        return false;
+    }
+    
+    if (this->compressed_storage_) {
+        return this->decode_compressed_table_(buf, size, table);
+    }
+    
+    size_t stored_values = std::min(this->schedule_max_size_, size / sizeof(uint16_t));
+    table.resize(stored_values);
+    std::memcpy(table.data(), buf, stored_values * sizeof(uint16_t));
+    // Check for terminator [0xFFFF, 0xFFFF] - used by both state-based and event-based.
+    // The storage header gives the exact length, so only that position is checked. Records without
+    // it are scanned; event times never equal 0xFFFF, so every position is checked there
+    // (event-based tables may be odd length)
+    size_t terminator = stored_values;
+    size_t exact = this->stored_entry_count_;
+    if (exact >= 2 && exact <= stored_values) {
+        if (table[exact - 2] == 0xFFFF && table[exact - 1] == 0xFFFF) {
+            terminator = exact - 2;
+        }
+    } else {
+        for (size_t i = 0; i + 1 < stored_values; ++i) {
+            if (table[i] == 0xFFFF && table[i + 1] == 0xFFFF) {
+                terminator = i;
+                break;
+            }
+        }
+    }
+    if (terminator == stored_values) {
+        return false;
+    }
+    ESP_LOGI(TAG, "Found terminator at index %u; actual schedule size is %u values", 
+             static_cast<unsigned>(terminator), static_cast<unsigned>(terminator));
+    // Keep only the real events plus the terminator
+    table.resize(terminator + 2);
+    this->stored_table_bytes_ = table.size() * sizeof(uint16_t);
+    // Solar anchors hold a placeholder time until the date is known
+    this->solar_anchors_.clear();
+    for (size_t pos = 0; pos < terminator; ++pos) {
+        if (table[pos] & SOLAR_BIT) {
+            this->solar_anchors_.push_back({static_cast<uint16_t>(pos), table[pos]});
+            table[pos] = this->resolve_solar_anchor_(table[pos], 0, 0, 0);
+        }
+    }
+    this->solar_day_ = 0xFFFF;
+    return true;
+}
+
+size_t Schedule::encode_compressed_table_(uint8_t *buf, size_t capacity) const {
+    return encode_compressed_table(this->schedule_times_in_minutes_.data(), this->schedule_event_count_,
+                                   this->get_storage_multiplier() == 1, buf, capacity);
+}
+
+bool Schedule::decode_compressed_table_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) {
+    size_t used = decode_compressed_table(buf, size, this->get_storage_multiplier() == 1, this->schedule_max_size_, table);
+    if (used == 0) {
+        ESP_LOGW(TAG, "Stored schedule is not a valid compressed table");
+        return false;
+    }
+    this->solar_anchors_.clear();
+    this->stored_table_bytes_ = used;
+    ESP_LOGI(TAG, "Decoded %u compressed events from %u bytes", static_cast<unsigned>(table.size() - 2),
+             static_cast<unsigned>(used));
+    return true;
 }
 
 void Schedule::load_entity_id_from_pref_() {
@@ -701,7 +1819,7 @@ void Schedule::load_entity_id_from_pref_() {
 
 void Schedule::save_entity_id_to_pref_() {
     uint32_t entity_pref_hash = fnv1_hash("entity_id") ^ this->get_object_id_hash();
-    uint32_t current_hash = fnv1_hash(this->ha_schedule_entity_id_);
+    uint32_t current_hash = this->entity_ids_hash_();
     
     auto restore = global_preferences->make_preference<uint32_t>(entity_pref_hash);
     restore.save(&current_hash);
@@ -714,6 +1832,29 @@ void Schedule::sched_add_pref(ArrayPreferenceBase *array_pref) {
   sched_array_pref_ = array_pref;
 }
 
+void Schedule::index_schedule_table_() {
+    // Cache the terminator position so lookups never rescan for 0xFFFF
+    this->schedule_event_count_ = 0;
+    while (this->schedule_event_count_ < this->schedule_times_in_minutes_.size() &&
+           this->schedule_times_in_minutes_[this->schedule_event_count_] != 0xFFFF) {
+        this->schedule_event_count_++;
+    }
+    
+    // Build the per-day bucket index in the same pass over the sorted table
+    uint8_t day = 0;
+    this->day_start_index_[0] = 0;
+    for (size_t i = 0; i < this->schedule_event_count_; ++i) {
+        uint8_t event_day = std::min<uint16_t>((this->schedule_times_in_minutes_[i] & TIME_MASK) / 1440, 6);
+        while (day < event_day) {
+            this->day_start_index_[++day] = static_cast<uint16_t>(i);
+        }
+    }
+    while (day < 7) {
+        this->day_start_index_[++day] = static_cast<uint16_t>(this->schedule_event_count_);
+    }
+    ESP_LOGV(TAG, "Schedule table indexed: %u events", static_cast<unsigned>(this->schedule_event_count_));
+}
+
 //==============================================================================
 // HOME ASSISTANT INTEGRATION
 //==============================================================================
@@ -738,7 +1879,12 @@ void Schedule::setup_schedule_retrieval_service_() {
         
         this->ha_get_schedule_action_->set_service("schedule.get_schedule");
         this->ha_get_schedule_action_->init_data(1);
-        this->ha_get_schedule_action_->add_data("entity_id", this->ha_schedule_entity_id_);
+        // A rotation fetches every week's schedule in the same call
+        std::string entity_ids = this->ha_schedule_entity_id_;
+        for (const auto &rotation_entity_id : this->rotation_entity_ids_) {
+            entity_ids += "," + rotation_entity_id;
+        }
+        this->ha_get_schedule_action_->add_data("entity_id", entity_ids);
         this->ha_get_schedule_action_->init_data_template(0);
         this->ha_get_schedule_action_->init_variables(0);
         this->ha_get_schedule_action_->set_wants_status();
@@ -882,6 +2028,8 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
     JsonObjectConst schedule = response["response"][this->ha_schedule_entity_id_.c_str()];
     
     work_buffer_.clear();
+    this->parsed_seconds_.clear();
+    this->parsed_solar_.clear();
     
     // Create temporary work buffers for each data sensor to collect values during parsing
     std::vector<std::vector<std::string>> data_work_buffers;
@@ -889,16 +2037,194 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
         data_work_buffers.emplace_back(std::vector<std::string>());
     }
     
+    // Parse the seven days of the primary schedule
+    uint16_t day_start[8];
+    if (!this->parse_schedule_week_(schedule, work_buffer_, data_work_buffers, day_start)) {
+        return;
+    }
+    
+    // Rotation: parse the other weeks and keep every distinct day pattern once
+    bool rotation_empty = true;
+    if (this->is_rotating_() && !this->process_rotation_weeks_(response, work_buffer_, day_start, rotation_empty)) {
+        return;
+    }
+    
+    // Check if schedule is empty (no time entries in any rotation week)
+    bool is_empty = this->is_rotating_() ? rotation_empty : work_buffer_.empty();
+    
+    // A larger schedule grows the capacity, up to schedule_size_limit, instead of being truncated
+    size_t multiplier = this->get_storage_multiplier();
+    size_t received_entries = (work_buffer_.size() + multiplier - 1) / multiplier;
+    if (!this->is_rotating_() && received_entries > this->schedule_max_entries_) {
+        this->grow_schedule_capacity_(std::min(received_entries, this->get_schedule_size_limit()));
+    }
+    
+    // Check size against max size (the terminator takes the last 2 values)
+    size_t max_event_values = this->schedule_max_size_ - 2;
+    if (work_buffer_.size() > max_event_values) {
+        ESP_LOGW(TAG, "Received schedule (%u entries) exceeds max size (%u); truncating.", 
+                 static_cast<unsigned>(work_buffer_.size() + 2), static_cast<unsigned>(this->schedule_max_size_));
+        std::string msg = "Schedule too large: Received " + std::to_string(work_buffer_.size() + 2) + 
+                          " entries but max size is " + std::to_string(this->schedule_max_size_) + 
+                          ". Schedule has been truncated. Consider reducing schedule complexity or increasing schedule_size_limit.";
+        this->send_ha_notification_(msg, "Schedule Warning");
+        work_buffer_.resize(max_event_values);
+        if (this->parsed_seconds_.size() > max_event_values) {
+            this->parsed_seconds_.resize(max_event_values);
+        }
+        
+        // Truncate data work buffers to match
+        size_t max_entries = this->schedule_max_entries_;
+        for (auto &buffer : data_work_buffers) {
+            if (buffer.size() > max_entries) {
+                buffer.resize(max_entries);
+            }
+        }
+    }
+    
+    // Append terminating values [0xFFFF, 0xFFFF] - used by both storage types
+    work_buffer_.push_back(0xFFFF);
+    work_buffer_.push_back(0xFFFF);
+    
+    // All data validated and processed successfully
+    ESP_LOGD(TAG, "Processed schedule with %u entries successfully.", 
+             static_cast<unsigned>((work_buffer_.size() - 2) / this->get_storage_multiplier()));
+    // Store the processed schedule times in schedule runtime buffer
+    this->schedule_times_in_minutes_ = std::move(work_buffer_);
+    this->event_seconds_ = std::move(this->parsed_seconds_);
+    this->parsed_seconds_.clear();
+    this->index_schedule_table_();
+    // Solar times of truncated entries go with them; the rest are resolved on the next pass
+    this->solar_anchors_.clear();
+    for (const auto &anchor : this->parsed_solar_) {
+        if (anchor.position < this->schedule_event_count_) {
+            this->solar_anchors_.push_back(anchor);
+        }
+    }
+    this->parsed_solar_.clear();
+    this->solar_day_ = 0xFFFF;
+    this->on_schedule_parsed_();
+    // Populate each data sensor with its runtime buffer
+    for (size_t sensor_idx = 0; sensor_idx < this->data_sensors_.size(); ++sensor_idx) {
+        DataSensor *sensor = this->data_sensors_[sensor_idx];
+        sensor->clear_data_vector();
+        
+        for (size_t entry_idx = 0; entry_idx < data_work_buffers[sensor_idx].size(); ++entry_idx) {
+            sensor->add_schedule_data_to_sensor(data_work_buffers[sensor_idx][entry_idx], entry_idx);
+        }
+        
+        // Sensor data is saved with the schedule below, as one generation
+        
+        ESP_LOGI(TAG, "Populated sensor '%s' with %u entries", 
+                 sensor->get_label().c_str(), static_cast<unsigned>(data_work_buffers[sensor_idx].size()));
+    }
+
+    ESP_LOGI(TAG, "Processing complete");
+    // Persist the new schedule to flash    
+    save_schedule_to_pref_();
+    ESP_LOGD(TAG, "Preference writes: %u, skipped as unchanged: %u",
+             static_cast<unsigned>(this->get_pref_write_count()),
+             static_cast<unsigned>(this->get_skipped_pref_write_count()));
+    this->publish_pref_write_counts_();
+    // Mark schedule as valid after successful processing
+    this->schedule_valid_ = true;
+    
+    // Set schedule_empty based on whether we found any schedule entries
+    this->schedule_empty_ = is_empty;
+    
+    if (is_empty) {
+        ESP_LOGI(TAG, "Empty (no time entries found)");
+    }
+    
+    // Always notify derived class on schedule update to ensure mode select is updated
+    // (not just when empty state changes, to handle edge cases)
+    this->on_schedule_empty_changed(is_empty);
+    
+    // IMPORTANT: Force reinitialization to find new current/next events
+    // The loop() will detect INIT state and call initialize_schedule_operation_()
+    ESP_LOGI(TAG, "Forcing schedule reinitialization to update current/next events");
+    this->force_reinitialize();
+    
+    log_state_flags_();
+}
+
+bool Schedule::process_rotation_weeks_(const JsonObjectConst &response, std::vector<uint16_t> &work_buffer,
+                                       const uint16_t *day_start, bool &all_empty) {
+    std::vector<uint16_t> patterns;
+    std::vector<uint16_t> offsets;
+    std::vector<uint16_t> days;
+    this->rotation_patterns_.swap(patterns);
+    this->rotation_pattern_offsets_.swap(offsets);
+    
+    std::vector<uint16_t> week_buffer = std::move(work_buffer);
+    uint16_t week_day_start[8];
+    std::copy(day_start, day_start + 8, week_day_start);
+    // Data items are not supported with rotations; the scratch buffers only satisfy the parser
+    std::vector<std::vector<std::string>> unused_data(this->data_sensors_.size());
+    size_t max_event_values = this->schedule_max_size_ - 2;
+    
+    for (size_t week = 0; week < this->get_rotation_weeks(); ++week) {
+        if (week > 0) {
+            const std::string &entity_id = this->rotation_entity_ids_[week - 1];
+            if (!response["response"][entity_id.c_str()].is<JsonObjectConst>()) {
+                ESP_LOGW(TAG, "Rotation entity '%s' not found in response", entity_id.c_str());
+                this->send_ha_notification_("Schedule retrieval failed: Rotation entity '" + entity_id + "' not found in response",
+                                            "Schedule Error");
+                break;
+            }
+            week_buffer.clear();
+            if (!this->parse_schedule_week_(response["response"][entity_id.c_str()], week_buffer, unused_data, week_day_start)) {
+                break;
+            }
+        }
+        if (week_buffer.size() > max_event_values) {
+            ESP_LOGW(TAG, "Rotation week %u exceeds max size; aborting", static_cast<unsigned>(week));
+            this->send_ha_notification_("Schedule too large: Rotation week " + std::to_string(week) +
+                                        " has more entries than max_schedule_size allows.", "Schedule Error");
+            break;
+        }
+        
+        // Split the week into days and share identical day patterns across all weeks
+        for (uint8_t day = 0; day < 7; ++day) {
+            std::vector<uint16_t> relative(week_buffer.begin() + week_day_start[day], week_buffer.begin() + week_day_start[day + 1]);
+            for (auto &event : relative) {
+                event = ((event & TIME_MASK) - day * 1440) | (event & SWITCH_STATE_BIT);
+            }
+            all_empty = all_empty && relative.empty();
+            days.push_back(this->intern_day_pattern_(relative.data(), relative.size()));
+        }
+    }
+    
+    if (days.size() != this->get_rotation_weeks() * 7) {
+        // Keep the previous rotation untouched
+        this->rotation_patterns_.swap(patterns);
+        this->rotation_pattern_offsets_.swap(offsets);
+        return false;
+    }
+    
+    this->rotation_days_ = std::move(days);
+    this->active_rotation_week_ = this->current_rotation_week_();
+    this->rotation_check_day_ = this->last_tick_.time_valid ? this->last_tick_.now.day_of_year : 0xFFFF;
+    this->build_rotation_table_(this->active_rotation_week_, work_buffer);
+    ESP_LOGI(TAG, "Processed %u-week rotation: %u distinct day patterns", 
+             static_cast<unsigned>(this->get_rotation_weeks()), static_cast<unsigned>(this->rotation_pattern_offsets_.size()));
+    return true;
+}
+
+bool Schedule::parse_schedule_week_(const JsonObjectConst &schedule, std::vector<uint16_t> &work_buffer,
+                                    std::vector<std::vector<std::string>> &data_work_buffers,
+                                    uint16_t *day_start) {
     // Iterate over each day of the week
     const char* days[] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
     uint16_t day_offset_minutes = 0;
     
     for (int i = 0; i < 7; ++i) {
+        day_start[i] = static_cast<uint16_t>(work_buffer.size());
         if (!schedule[days[i]].is<JsonArrayConst>()) {
             ESP_LOGE(TAG, "Day '%s' not found; aborting", days[i]);
             std::string msg = "Schedule parsing failed: Day '" + std::string(days[i]) + "' not found. Schedule data is corrupted or incomplete.";
             this->send_ha_notification_(msg, "Schedule Error");
-            return;
+            return false;
         }
         JsonArrayConst day_array = schedule[days[i]].as<JsonArrayConst>();
         
@@ -908,7 +2234,7 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                 ESP_LOGE(TAG, "Invalid or missing 'from'/'to' fields in %s; aborting", days[i]);
                 std::string msg = "Schedule parsing failed: Invalid or missing 'from'/'to' fields in " + std::string(days[i]) + ". Please verify the schedule configuration.";
                 this->send_ha_notification_(msg, "Schedule Error");
-                return;
+                return false;
             }
             
             if (!(this->isValidTime_(entry["from"]) && this->isValidTime_(entry["to"]))) {
@@ -920,22 +2246,25 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                                   " (from='" + std::string(entry["from"].as<const char*>()) + 
                                   "', to='" + std::string(entry["to"].as<const char*>()) + "'). Please verify the schedule configuration.";
                 this->send_ha_notification_(msg, "Schedule Error");
-                return;
+                return false;
             }
             
             // EXTENSIBILITY: Call virtual method to parse entry based on storage type
             // Default (state-based): stores [ON_TIME, OFF_TIME] pairs
             // Event-based override: stores [EVENT_TIME] singles
-            this->parse_schedule_entry(entry, work_buffer_, day_offset_minutes);
+            this->parse_schedule_entry(entry, work_buffer, day_offset_minutes);
             
             // Check if entry has "data" field
             if (!entry["data"].is<JsonObjectConst>()) {
                 ESP_LOGE(TAG, "Missing 'data' field in %s entry; aborting", days[i]);
-                return;
+                return false;
             }
             
             JsonObjectConst data = entry["data"].as<JsonObjectConst>();
             
+            // Sunrise/sunset-relative times replace the fixed ones once resolved
+            this->parse_solar_anchors_(data, work_buffer, work_buffer.size() - this->get_storage_multiplier(), i);
+            
             // Process each data item for this entry
             for (size_t sensor_idx = 0; sensor_idx < this->data_sensors_.size(); ++sensor_idx) {
                 DataSensor *sensor = this->data_sensors_[sensor_idx];
@@ -945,7 +2274,7 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                 if (!data[label.c_str()].is<JsonVariantConst>()) {
                     ESP_LOGE(TAG, "Missing data field '%s' in %s entry; aborting", 
                              label.c_str(), days[i]);
-                    return;
+                    return false;
                 }
                 
                 JsonVariantConst data_value = data[label.c_str()];
@@ -966,7 +2295,7 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                                               std::string(days[i]) + " is not an integer type (expected for item_type " + 
                                               std::to_string(item_type) + ").";
                             this->send_ha_notification_(msg, "Schedule Error");
-                            return;
+                            return false;
                         }
                         value_str = std::to_string(data_value.as<long>());
                         break;
@@ -980,7 +2309,7 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                                               std::string(days[i]) + " is not a numeric type (expected for item_type " + 
                                               std::to_string(item_type) + ").";
                             this->send_ha_notification_(msg, "Schedule Error");
-                            return;
+                            return false;
                         }
                         value_str = std::to_string(data_value.as<float>());
                         break;
@@ -991,7 +2320,7 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
                         std::string msg = "Schedule parsing failed: Unknown item_type " + std::to_string(item_type) + 
                                           " for sensor '" + label + "'. Expected types: 0=uint8_t, 1=uint16_t, 2=int32_t, 3=float.";
                         this->send_ha_notification_(msg, "Schedule Error");
-                        return;
+                        return false;
                 }
                 
                 // Add to work buffer for this sensor
@@ -1002,79 +2331,8 @@ void Schedule::process_schedule_(const ArduinoJson::JsonObjectConst &response) {
         // Offset for the next day: each day is 1440 minutes (24 hours)
         day_offset_minutes += 1440;
     }
-    
-    // Append terminating values [0xFFFF, 0xFFFF] - used by both storage types
-    work_buffer_.push_back(0xFFFF);
-    work_buffer_.push_back(0xFFFF);
-    
-    // Check if schedule is empty (only contains terminator)
-    bool is_empty = (work_buffer_.size() == this->get_storage_multiplier());
-    
-    // Check size against max size
-    if (work_buffer_.size() > this->schedule_max_size_) {
-        ESP_LOGW(TAG, "Received schedule (%u entries) exceeds max size (%u); truncating.", 
-                 static_cast<unsigned>(work_buffer_.size()), static_cast<unsigned>(this->schedule_max_size_));
-        std::string msg = "Schedule too large: Received " + std::to_string(work_buffer_.size()) + 
-                          " entries but max size is " + std::to_string(this->schedule_max_size_) + 
-                          ". Schedule has been truncated. Consider reducing schedule complexity or increasing max_schedule_size.";
-        this->send_ha_notification_(msg, "Schedule Warning");
-        work_buffer_.resize(this->schedule_max_size_);
-        
-        // Truncate data work buffers to match
-        size_t max_entries = this->schedule_max_size_ / 2;
-        for (auto &buffer : data_work_buffers) {
-            if (buffer.size() > max_entries) {
-                buffer.resize(max_entries);
-            }
-        }
-    }
-    // fill the remainder with zeros to maintain constant size
-    while (work_buffer_.size() < this->schedule_max_size_) {
-        work_buffer_.push_back(0);
-    }   
-    // All data validated and processed successfully
-    ESP_LOGD(TAG, "Processed schedule with %u entries successfully.", static_cast<unsigned>(work_buffer_.size()) / 2);
-    // Store the processed schedule times in schedule runtime buffer
-    this->schedule_times_in_minutes_ = work_buffer_;
-    // Populate each data sensor with its runtime buffer
-    for (size_t sensor_idx = 0; sensor_idx < this->data_sensors_.size(); ++sensor_idx) {
-        DataSensor *sensor = this->data_sensors_[sensor_idx];
-        sensor->clear_data_vector();
-        
-        for (size_t entry_idx = 0; entry_idx < data_work_buffers[sensor_idx].size(); ++entry_idx) {
-            sensor->add_schedule_data_to_sensor(data_work_buffers[sensor_idx][entry_idx], entry_idx);
-        }
-        
-        // Save sensor data from runtime vector to preferences
-        sensor->save_data_to_pref();
-        
-        ESP_LOGI(TAG, "Populated sensor '%s' with %u entries", 
-                 sensor->get_label().c_str(), static_cast<unsigned>(data_work_buffers[sensor_idx].size()));
-    }
-
-    ESP_LOGI(TAG, "Processing complete");
-    // Persist the new schedule to flash    
-    save_schedule_to_pref_();
-    // Mark schedule as valid after successful processing
-    this->schedule_valid_ = true;
-    
-    // Set schedule_empty based on whether we found any schedule entries
-    this->schedule_empty_ = is_empty;
-    
-    if (is_empty) {
-        ESP_LOGI(TAG, "Empty (no time entries found)");
-    }
-    
-    // Always notify derived class on schedule update to ensure mode select is updated
-    // (not just when empty state changes, to handle edge cases)
-    this->on_schedule_empty_changed(is_empty);
-    
-    // IMPORTANT: Force reinitialization to find new current/next events
-    // The loop() will detect INIT state and call initialize_schedule_operation_()
-    ESP_LOGI(TAG, "Forcing schedule reinitialization to update current/next events");
-    this->force_reinitialize();
-    
-    log_state_flags_();
+    day_start[7] = static_cast<uint16_t>(work_buffer.size());
+    return true;
 }
 
 void Schedule::parse_schedule_entry(const JsonObjectConst &entry, 
@@ -1086,6 +2344,12 @@ void Schedule::parse_schedule_entry(const JsonObjectConst &entry,
     
     work_buffer.push_back(from + day_offset);
     work_buffer.push_back(to + day_offset);
+    
+    // Keep the seconds HA sends when running at second resolution
+    if (this->second_resolution_) {
+        this->parsed_seconds_.push_back(this->timeToSeconds_(entry["from"]));
+        this->parsed_seconds_.push_back(this->timeToSeconds_(entry["to"]));
+    }
 }
 
 //==============================================================================
@@ -20,8 +20,14 @@
 #include <string>
 #include <cstring>
 #include <map>
+#include <algorithm>
 #include "array_preference.h"
 #include "data_sensor.h"
+#include "schedule_tick_service.h"
+#include "schedule_encoding.h"
+#include "schedule_calendar.h"
+#include "schedule_bitmap.h"
+#include "schedule_solar.h"
 
 // Macro to safely get data sensor value from schedule by label
 // Usage: float temp = SCHEDULE_GET_DATA(testschedule, "temp");
@@ -47,19 +53,62 @@ template <typename... Ts> class HomeAssistantServiceCallAction;
 
 namespace schedule {
 
-// Constants for schedule event encoding
-static constexpr uint16_t SWITCH_STATE_BIT = 0x4000;  // Bit 14: switch state
-static constexpr uint16_t TIME_MASK = 0x3FFF;         // Bits 0-13: time in minutes
-
 // Enum for storage type - determines how schedule data is stored
 enum ScheduleStorageType {
   STORAGE_TYPE_STATE_BASED = 0,  // Stores [ON_TIME, OFF_TIME] pairs (default)
-  STORAGE_TYPE_EVENT_BASED = 1   // Stores [EVENT_TIME] singles only
+  STORAGE_TYPE_EVENT_BASED = 1,  // Stores [EVENT_TIME] singles only
+  STORAGE_TYPE_BITMAP = 2        // Stores a 10080-bit minute-of-week bitmap (optionally run-length encoded)
+};
+
+// Per-date override of the weekly pattern (holidays, shutdown weeks)
+enum DayException : uint8_t {
+  DAY_EXCEPTION_NONE = 0,        // Follow the weekly schedule
+  DAY_EXCEPTION_AS_MONDAY = 1,   // Run that weekday's pattern instead
+  DAY_EXCEPTION_AS_TUESDAY = 2,
+  DAY_EXCEPTION_AS_WEDNESDAY = 3,
+  DAY_EXCEPTION_AS_THURSDAY = 4,
+  DAY_EXCEPTION_AS_FRIDAY = 5,
+  DAY_EXCEPTION_AS_SATURDAY = 6,
+  DAY_EXCEPTION_AS_SUNDAY = 7,
+  DAY_EXCEPTION_OFF = 8          // No ON periods or events for the whole day
+};
+
+// Result of Schedule::state_at() - the scheduled state at a point in the week
+struct ScheduleState {
+  bool valid{false};        // false when no schedule is loaded or it is empty
+  bool on{false};           // Scheduled switch state (always true for event-based schedules)
+  int16_t event_index{-1};  // Event in effect at the queried time
+  int16_t data_index{-1};   // Index of the entry's data values, -1 while scheduled OFF
+};
+
+// One upcoming transition returned by Schedule::next_events()
+// Data values are not copied in: a schedule has any number of labelled items, and a fixed-size
+// struct keeps the query allocation-free. Read them with Schedule::get_data_value(label, data_index).
+struct ScheduleTransition {
+  uint32_t week_second{0};    // Seconds from Monday 00:00
+  uint32_t seconds_until{0};  // Seconds from the query time until the transition
+  bool on{false};
+  int16_t event_index{-1};
+  int16_t data_index{-1};     // Index of the entry's data values, -1 for OFF transitions
+};
+
+// A table word whose time follows sunrise or sunset
+struct SolarAnchor {
+  uint16_t position;  // Word index in the runtime table
+  uint16_t stored;    // SOLAR_BIT encoded day, anchor and offset (plus the switch state bit)
 };
 
 // Forward declarations
 class Schedule;
 class ScheduleSwitch;
+class ScheduleLeadTrigger;
+
+// Which upcoming transitions an on_before_event trigger fires for
+enum LeadTriggerFilter : uint8_t {
+  LEAD_TRIGGER_ANY = 0,
+  LEAD_TRIGGER_ON = 1,
+  LEAD_TRIGGER_OFF = 2
+};
 
 // UpdateScheduleButton class - button to trigger schedule update
 class UpdateScheduleButton : public button::Button, public Component {
@@ -107,9 +156,10 @@ class Schedule : public Component  {
   /** Get storage multiplier for array size calculation 
    * State-based: 2 (ON + OFF per entry)
    * Event-based: 1 (EVENT only per entry)
+   * Bitmap: 2 (the runtime table is decoded back into ON/OFF transitions)
    */
   virtual size_t get_storage_multiplier() const {
-    return (get_storage_type() == STORAGE_TYPE_STATE_BASED) ? 2 : 1;
+    return (get_storage_type() == STORAGE_TYPE_EVENT_BASED) ? 1 : 2;
   }
   
   /** Parse a single schedule entry from Home Assistant JSON
@@ -119,6 +169,11 @@ class Schedule : public Component  {
   virtual void parse_schedule_entry(const JsonObjectConst &entry, 
                                     std::vector<uint16_t> &work_buffer,
                                     uint16_t day_offset);
+  
+  /** Called once a parsed HA schedule has replaced the runtime table, before it is saved
+   * Override to adopt per-entry data collected by parse_schedule_entry()
+   */
+  virtual void on_schedule_parsed_() {}
 
   //============================================================================
   // COMPONENT LIFECYCLE METHODS
@@ -128,8 +183,106 @@ class Schedule : public Component  {
   
   void set_max_schedule_entries(size_t entries);
   void set_max_schedule_size(size_t size);
+  /** Entries the schedule may grow to at runtime when Home Assistant sends a larger schedule.
+   * Records and data columns are resized in place; capacity is never below max_schedule_size.
+   */
+  void set_schedule_size_limit(size_t entries) { this->schedule_size_limit_ = entries; }
+  size_t get_schedule_size_limit() const { return std::max(this->schedule_size_limit_, this->schedule_max_entries_); }
   void set_update_schedule_on_reconnect(bool update) { this->update_on_reconnect_ = update; }
+  /** Keep the seconds of "HH:MM:SS" event times and fire on the exact second.
+   * Stored as uint32_t seconds-of-week plus flag bits instead of uint16_t minutes.
+   */
+  void set_second_resolution(bool enabled) { this->second_resolution_ = enabled; }
+  bool has_second_resolution() const { return this->second_resolution_; }
+  /** Store the event table and every data sensor column in the schedule's own preference:
+   * one versioned record, read once at boot and written with a single save and sync.
+   */
+  void set_combined_storage(bool enabled) { this->combined_storage_ = enabled; }
+  bool has_combined_storage() const { return this->combined_storage_; }
+  /** Store the table as delta/varint tokens instead of raw uint16_t words.
+   * Minute-resolution weekly tables only (no rotation, solar times or bitmap).
+   */
+  void set_compressed_storage(bool enabled) { this->compressed_storage_ = enabled; }
+  bool has_compressed_storage() const { return this->compressed_storage_; }
   size_t get_max_schedule_entries() const { return this->schedule_max_entries_; }
+  size_t get_schedule_event_count() const { return this->schedule_event_count_; }
+  
+  /** Get the range of event indices [first, last) falling on a day (Monday = 0)
+   * Uses the per-day bucket index, so day-local queries never walk from index 0
+   */
+  void get_day_event_range(uint8_t day, size_t &first, size_t &last) const {
+    if (day > 6) {
+      first = last = this->schedule_event_count_;
+      return;
+    }
+    first = this->day_start_index_[day];
+    last = this->day_start_index_[day + 1];
+  }
+  
+  //============================================================================
+  // SCHEDULE QUERIES (allocation-free, usable from lambdas and other components)
+  //============================================================================
+  
+  /** Scheduled state at a minute of the week (Monday 00:00 = 0)
+   * O(log n) lookup in the day's bucket; ignores modes and manual overrides.
+   */
+  ScheduleState state_at(uint16_t week_minute, uint8_t second = 0) const;
+  
+  /** Fill out with up to max_count transitions following the current wall time, in order
+   * Transitions repeat weekly, so max_count may exceed the number of events.
+   * @return number of transitions written (0 if the time or schedule is not valid)
+   */
+  size_t next_events(ScheduleTransition *out, size_t max_count) const;
+  /** As above, following a minute of the week (Monday 00:00 = 0) instead of the current time */
+  size_t next_events(uint16_t week_minute, uint8_t second, ScheduleTransition *out, size_t max_count) const;
+  
+  /** Data value of an entry by item label, NAN if the label or index is unknown */
+  float get_data_value(const char *label, int16_t data_index) const;
+  
+  //============================================================================
+  // DAY EXCEPTIONS (holiday overlay on top of the weekly table)
+  //============================================================================
+  
+  /** Override every date from month/day to until_month/until_day inclusive (wraps past 31 Dec)
+   * Dates are independent of the year; the weekly table and stored schedule are untouched.
+   */
+  void add_day_exception(uint8_t month, uint8_t day, uint8_t until_month, uint8_t until_day,
+                         DayException exception);
+  void clear_day_exceptions();
+  /** Exception in force for a date, DAY_EXCEPTION_NONE if it follows the weekly schedule */
+  DayException get_day_exception(uint8_t month, uint8_t day) const;
+  
+  //============================================================================
+  // MULTI-WEEK ROTATION
+  //============================================================================
+  
+  /** Add the HA schedule used for the next week of the rotation (week 0 is ha_schedule_entity_id)
+   * All weeks are fetched with one service call and stored in one preference, each distinct
+   * day pattern only once.
+   */
+  void add_rotation_entity_id(const std::string &entity_id) { this->rotation_entity_ids_.push_back(entity_id); }
+  /** Shift which week runs rotation week 0: week = (epoch week + offset) % weeks */
+  void set_rotation_week_offset(uint8_t offset) { this->rotation_week_offset_ = offset; }
+  size_t get_rotation_weeks() const { return this->rotation_entity_ids_.size() + 1; }
+  /** Rotation week currently loaded into the runtime table */
+  uint8_t get_active_rotation_week() const { return this->active_rotation_week_; }
+  
+  //============================================================================
+  // SOLAR EVENTS
+  //============================================================================
+  
+  /** Sunrise/sunset table used to resolve entries with from_sun / to_sun in their data
+   * Entries are re-resolved once per date and the table re-sorted in place.
+   */
+  void set_solar_table(SolarTable *solar_table) { this->solar_table_ = solar_table; }
+  size_t get_solar_event_count() const { return this->solar_anchors_.size(); }
+  
+  //============================================================================
+  // LEAD TRIGGERS (on_before_event)
+  //============================================================================
+  
+  /** Fire a trigger a fixed time before the next event; armed with the event deadline */
+  void add_lead_trigger(ScheduleLeadTrigger *trigger);
   
   //============================================================================
   // INTERNAL IDENTIFICATION (for preferences - set by platform implementation)
@@ -155,9 +308,25 @@ class Schedule : public Component  {
   void set_next_event_sensor(text_sensor::TextSensor *sensor) {
     this->next_event_sensor_ = sensor;
   }
+  /** Diagnostic counters of preference writes made and skipped as unchanged since boot */
+  void set_pref_writes_sensor(sensor::Sensor *sensor) { this->pref_writes_sensor_ = sensor; }
+  void set_pref_writes_skipped_sensor(sensor::Sensor *sensor) { this->pref_writes_skipped_sensor_ = sensor; }
   void set_time(time::RealTimeClock *time) {
     this->time_ = time;
   }
+  void set_tick_service(ScheduleTickService *tick_service) {
+    this->tick_service_ = tick_service;
+  }
+  ScheduleTickService *get_tick_service() const { return this->tick_service_; }
+  
+  //============================================================================
+  // SHARED TICK (driven by ScheduleTickService)
+  //============================================================================
+  /** Run one schedule pass against the shared tick snapshot.
+   * Called by ScheduleTickService only when one of this schedule's timers expired
+   * or a wakeup was requested. Derived classes implement their state machine here.
+   */
+  virtual void process_tick(const ScheduleTick &tick) = 0;
   
   //============================================================================
   // UI UPDATE METHODS
@@ -177,6 +346,22 @@ class Schedule : public Component  {
   // PLATFORM-SPECIFIC METHODS (to be implemented by derived classes)
   //============================================================================
  protected:
+  /** Encode the runtime table into the schedule preference buffer
+   * Default implementation: the raw uint16_t table including its terminator
+   * @return bytes used, or 0 if the schedule does not fit in capacity
+   */
+  virtual size_t encode_schedule_storage_(uint8_t *buf, size_t capacity);
+  
+  /** Decode the schedule preference buffer into an exact-length table (events + terminator)
+   * Default implementation: scan the raw uint16_t table for its terminator
+   * @return false if the stored data is not a valid schedule
+   */
+  virtual bool decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table);
+  
+  /** Compressed table of schedule_encoding.h; returns 0 if it does not fit */
+  size_t encode_compressed_table_(uint8_t *buf, size_t capacity) const;
+  bool decode_compressed_table_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table);
+  
   /** Update the schedule state machine - call this from platform's loop().
    * 
    * This performs all schedule logic: checks time validity, HA connection,
@@ -208,7 +393,39 @@ class Schedule : public Component  {
   
   // Schedule configuration and data (protected for derived class access)
   size_t schedule_max_entries_{0};
-  std::vector<uint16_t> schedule_times_in_minutes_;
+  std::vector<uint16_t> schedule_times_in_minutes_;  // Exact length: events + [0xFFFF, 0xFFFF] terminator
+  size_t schedule_event_count_{0};                   // Cached terminator position (number of events)
+  // Per-day bucket index: day_start_index_[d] is the first event on day d (Monday = 0),
+  // day_start_index_[7] equals schedule_event_count_
+  uint16_t day_start_index_[8]{};
+  // Second within the minute for each event, parallel to schedule_times_in_minutes_
+  // (empty unless second resolution is enabled)
+  std::vector<uint8_t> event_seconds_;
+  std::vector<uint8_t> parsed_seconds_;  // Filled by parse_schedule_entry() while processing an update
+  bool second_resolution_{false};
+  
+  /** Second within the minute of an event (0 in minute resolution) */
+  uint8_t event_second_(int16_t index) const {
+    return (index >= 0 && static_cast<size_t>(index) < this->event_seconds_.size()) ? this->event_seconds_[index] : 0;
+  }
+  /** Seconds from start of week of an event */
+  uint32_t event_week_second_(int16_t index, uint16_t event_raw) const {
+    return (event_raw & TIME_MASK) * 60u + this->event_second_(index);
+  }
+  
+  /** Rebuild cached lookup data after schedule_times_in_minutes_ changes (load or HA update) */
+  void index_schedule_table_();
+  /** Parse the seven days of one HA schedule into work_buffer
+   * day_start receives the work_buffer position where each day begins (day_start[7] = end).
+   * @return false if the schedule is invalid (a notification has been sent)
+   */
+  bool parse_schedule_week_(const JsonObjectConst &schedule, std::vector<uint16_t> &work_buffer,
+                            std::vector<std::vector<std::string>> &data_work_buffers, uint16_t *day_start);
+  /** Parse the remaining rotation weeks, rebuild the shared day patterns and replace
+   * work_buffer with the events of the active week.
+   */
+  bool process_rotation_weeks_(const JsonObjectConst &response, std::vector<uint16_t> &work_buffer,
+                               const uint16_t *day_start, bool &all_empty);
   
   // Data sensors are protected so platform implementations can access sensor values
   std::vector<DataSensor*> data_sensors_;
@@ -229,6 +446,86 @@ class Schedule : public Component  {
   void load_schedule_from_pref_();
   void save_schedule_to_pref_();
   void sched_add_pref(ArrayPreferenceBase *array_pref);
+  /** Data entries of the stored records, or 0 when they can be loaded as they are (nothing to migrate) */
+  size_t get_stored_data_entries() const;
+  /** Whether stored records use the chunked layout (false: single blobs written by an older build) */
+  bool stored_records_chunked() const {
+    return this->storage_footprint_valid_ && this->storage_footprint_.version >= FOOTPRINT_VERSION_CHUNKED;
+  }
+  uint32_t get_slot_generation() const { return this->slot_generation_; }
+
+ protected:
+  // Layout byte: payload encoding, with the high bit set for event-based tables
+  static constexpr uint8_t STORAGE_LAYOUT_TABLE = 0x01;
+  static constexpr uint8_t STORAGE_LAYOUT_WIDE = 0x02;
+  static constexpr uint8_t STORAGE_LAYOUT_ROTATION = 0x03;
+  static constexpr uint8_t STORAGE_LAYOUT_COMPRESSED = 0x04;
+  static constexpr uint8_t STORAGE_LAYOUT_BITMAP = 0x05;
+  static constexpr uint8_t STORAGE_LAYOUT_EVENT_FLAG = 0x80;
+  virtual uint8_t storage_layout_() const;
+
+  /** Record size and capacity (entries) the schedule was last saved with, kept in a small preference of
+   * its own so a record saved with another size can still be read and migrated, and capacity grown at
+   * runtime is restored at boot
+   */
+  struct StorageFootprint {
+    uint32_t record_bytes;
+    uint16_t entries;
+    uint16_t version;
+  };
+  // Version 1 records are single blobs; version 2 records are stored in ArrayPreference chunks
+  static constexpr uint16_t FOOTPRINT_VERSION_BLOB = 1;
+  static constexpr uint16_t FOOTPRINT_VERSION_CHUNKED = 2;
+  void load_storage_footprint_();
+  void save_storage_footprint_();
+  /** Raise capacity to entries (up to schedule_size_limit): table, data columns and their records */
+  void grow_schedule_capacity_(size_t entries);
+
+  /** A/B slots: an update writes the schedule and data sensor records into the slot not holding the
+   * committed generation; the slot pointer is written last, after those records are on flash, so a
+   * power loss mid-update leaves the previous generation intact. The low bit of the generation names the slot.
+   */
+  struct SlotPointer {
+    uint32_t generation;
+    uint32_t check;  // ~generation
+  };
+  void load_slot_pointer_();
+  /** Save every record of the update (schedule and data sensors) as one generation */
+  void write_generation_();
+  void commit_slot_pointer_();
+  /** Records that make up one generation: the schedule record and each data sensor's own record */
+  std::vector<ArrayPreferenceBase *> generation_records_();
+
+  /** Read a schedule record of the given size laid out for data_entries per data column. Headerless
+   * records written before the storage header existed are accepted when legacy is set.
+   */
+  bool read_schedule_record_(const uint8_t *record, size_t size, size_t data_entries, bool legacy,
+                             std::vector<uint16_t> &table);
+  /** Fetch the record saved under an older size or format for read_schedule_record_() */
+  bool load_previous_record_(std::vector<uint8_t> &record);
+  size_t data_entries_() const;
+
+  // Combined record: [magic, version, sensor count] header, table region, then data columns in sensor order
+  static constexpr uint16_t COMBINED_RECORD_MAGIC = 0x5343;
+  static constexpr uint8_t COMBINED_RECORD_VERSION = 1;
+  static constexpr size_t COMBINED_HEADER_BYTES = 4;
+  /** Bytes of the data columns in a combined record with data_entries per column */
+  size_t combined_columns_bytes_(size_t data_entries) const;
+  /** Bytes of the preference that hold the encoded table (all of it after the headers unless combined) */
+  size_t table_region_size_() const;
+  uint8_t *table_region_();
+  /** Combined header written by this build with a matching sensor count */
+  bool check_combined_header_(const uint8_t *header) const;
+  /** Copy every data sensor column into the combined record */
+  void write_combined_columns_();
+  /** Fill the data sensors from columns of data_entries each; extra entries are dropped, missing ones zeroed */
+  void read_combined_columns_(const uint8_t *columns, size_t data_entries);
+  /** Publish the write counters to their diagnostic sensors, when configured */
+  void publish_pref_write_counts_();
+ public:
+  /** Flash writes made, and saves skipped because the content was unchanged (schedule and data sensors) */
+  uint32_t get_pref_write_count() const;
+  uint32_t get_skipped_pref_write_count() const;
   void request_pref_hash() {
     ESP_LOGI("schedule", "Preference Hash: %u", this->get_preference_hash());
   }
@@ -278,6 +575,7 @@ class Schedule : public Component  {
   // TIME AND FORMATTING UTILITIES (used by derived classes)
   //============================================================================
   uint16_t timeToMinutes_(const char* time_str);
+  uint8_t timeToSeconds_(const char* time_str);  // Seconds part of "HH:MM:SS" (0 for "HH:MM")
 
  protected:
   //============================================================================
@@ -292,15 +590,156 @@ class Schedule : public Component  {
   };
   
   PrerequisiteError check_prerequisites_();
-  bool should_advance_to_next_event_(uint16_t current_time_minutes);
+  /** True once the current time has left the [current event, next event) window of the week */
+  bool is_next_event_due_(uint32_t current_week_second) const;
+  //============================================================================
+  // CLOCK JUMP RESYNCHRONISATION
+  //============================================================================
+  // Wall-clock change against millis() between passes beyond which the clock is considered to have jumped
+  // (NTP/HA time correction, RTC set); smaller differences are handled by the normal due check
+  static constexpr int32_t CLOCK_JUMP_THRESHOLD_S = 90;
+  
+  /** Compare wall time against millis() since the previous pass.
+   * @return the jump in seconds (positive = forward), 0 if none; always updates the reference
+   */
+  int32_t detect_clock_jump_();
+  /** Re-seek current/next event with the O(log n) lookup instead of stepping event by event.
+   * Derived classes extend this with their own catch-up handling.
+   */
+  virtual void resync_after_clock_jump_(int32_t jump_s);
+  
+  //============================================================================
+  // DAY EXCEPTIONS
+  //============================================================================
+  // One entry per calendar date of a leap year, so 29 Feb has its own slot
+  static constexpr uint16_t DAYS_PER_EXCEPTION_TABLE = 366;
+  
+  /** Index of a date in the exception table (year independent) */
+  static uint16_t exception_day_key_(uint8_t month, uint8_t day);
+  /** Look up today's exception in O(1) and remap last_tick_.week_minute to the weekday it runs as.
+   * Called right after the tick is stored; flags a re-seek when the effective pattern changes.
+   */
+  void apply_day_exception_();
+  /** True once after the effective day pattern changed (date rollover or table edit) */
+  bool take_day_pattern_change_() {
+    bool changed = this->day_pattern_changed_;
+    this->day_pattern_changed_ = false;
+    return changed;
+  }
+  /** Today is overridden to have no ON periods or events */
+  bool is_day_off_() const { return this->active_day_exception_ == DAY_EXCEPTION_OFF; }
+  
+  //============================================================================
+  // MULTI-WEEK ROTATION
+  //============================================================================
+  // First stored word of a rotation preference; never a valid event or terminator
+  static constexpr uint16_t ROTATION_STORAGE_MARKER = 0xFFFD;
+  
+  bool is_rotating_() const { return !this->rotation_entity_ids_.empty(); }
+  /** Rotation week for the tick being processed (0 while time is not valid) */
+  uint8_t current_rotation_week_() const;
+  /** Rebuild the runtime table when the week selects another rotation week.
+   * Checked once per date; flags a re-seek like a day exception change.
+   */
+  void apply_rotation_week_();
+  /** Assemble one week's table (events + terminator) from the shared day patterns */
+  bool build_rotation_table_(uint8_t week, std::vector<uint16_t> &table) const;
+  /** Add a day's day-relative events to the pattern store, reusing an identical pattern */
+  uint16_t intern_day_pattern_(const uint16_t *events, size_t count);
+  /** Hash of the configured entity IDs, used to detect a changed configuration */
+  uint32_t entity_ids_hash_() const;
+  
+  //============================================================================
+  // SOLAR EVENTS
+  //============================================================================
+  /** Solar times are kept with the plain minute table only */
+  bool stores_solar_() const {
+    return this->solar_table_ != nullptr && !this->second_resolution_ && !this->is_rotating_() &&
+           this->get_storage_type() != STORAGE_TYPE_BITMAP;
+  }
+  /** Record from_sun / to_sun of the entry whose words start at first_word (day 0 = Monday) */
+  void parse_solar_anchors_(const JsonObjectConst &data, const std::vector<uint16_t> &work_buffer,
+                            size_t first_word, uint8_t day);
+  /** Minute-of-week word for a stored solar time on the next occurrence of its weekday */
+  uint16_t resolve_solar_anchor_(uint16_t stored, uint8_t today, uint16_t day_of_year, int16_t utc_offset) const;
+  /** Re-resolve the solar times once per date and restore the table order.
+   * Flags a re-seek like a day exception change.
+   */
+  void apply_solar_day_();
+  /** Insertion sort of whole entries by start time; O(n) when the order barely changed */
+  void sort_entries_incremental_();
+  /** Swap entry and entry + 1 with their data values and solar anchors */
+  void swap_entries_(size_t entry);
+  /** Called after entry and entry + 1 swapped places; override to move per-entry data */
+  virtual void on_entries_swapped_(size_t entry) {}
+  /** Local time minus UTC in minutes */
+  static int16_t utc_offset_minutes_(const ESPTime &now);
+  
+  //============================================================================
+  // DST TRANSITIONS
+  //============================================================================
+  /** Look up the next UTC offset change once per date and hold the schedule clock
+   * through a repeated hour, so events in it fire only the first time round.
+   * Events in a skipped hour are due as soon as the clock has jumped.
+   */
+  void apply_dst_rules_();
+  /** Look up the UTC offset change (see find_offset_change()) around timestamp */
+  void find_dst_transition_(time_t timestamp);
+  /** Local time minus UTC in seconds at a timestamp */
+  static int32_t utc_offset_seconds_(time_t timestamp) {
+    return utc_offset_minutes_(ESPTime::from_epoch_local(timestamp)) * 60;
+  }
+  
+  /** Seconds from start of week of the tick being processed */
+  uint32_t tick_week_second_() const {
+    return this->last_tick_.week_minute * 60u + this->last_tick_.now.second;
+  }
+  
+  //============================================================================
+  // DEADLINE-DRIVEN WAKEUPS (timer wheel owned by ScheduleTickService)
+  //============================================================================
+  // Polling interval used while no deadline is armed (error and INIT states)
+  static constexpr uint32_t WAKEUP_POLL_INTERVAL_S = 1;
+  // Upper bound on an armed deadline so RTC drift or silent clock changes are re-checked
+  static constexpr uint32_t WAKEUP_MAX_DEADLINE_S = 15 * 60;
+  
+  /** Request a full pass on the next loop (mode change, schedule update, time sync) */
+  void request_wakeup_() {
+    if (this->tick_service_ != nullptr) {
+      this->tick_service_->mark_due(this);
+    }
+  }
+  /** Arm a timer on the tick service; the schedule is processed when it expires */
+  void arm_timer_(WheelTimer *timer, uint32_t delay_s) {
+    if (this->tick_service_ != nullptr) {
+      this->tick_service_->arm_timer(timer, delay_s);
+    }
+  }
+  void cancel_timer_(WheelTimer *timer) {
+    if (this->tick_service_ != nullptr) {
+      this->tick_service_->cancel_timer(timer);
+    }
+  }
+  /** Poll again after WAKEUP_POLL_INTERVAL_S unless this pass arms the next event deadline */
+  void arm_poll_timer_() {
+    this->event_timer_is_deadline_ = false;
+    this->arm_timer_(&this->event_timer_, WAKEUP_POLL_INTERVAL_S);
+  }
+  /** Compute the delay to next_event_raw_ from the current tick and arm the event timer */
+  void arm_event_deadline_();
+  /** Arm each lead trigger delay_s (real seconds to the next event) minus its lead */
+  void arm_lead_triggers_(uint32_t delay_s);
+  void fire_lead_trigger_(ScheduleLeadTrigger *trigger);
+  /** Whether the next event will be applied, so lead triggers should fire for it */
+  virtual bool lead_triggers_enabled_() const { return true; }
   virtual void advance_to_next_event_();
   virtual void check_and_advance_events_();
   
   //============================================================================
   // CONFIGURATION AND SETUP HELPERS
   //============================================================================
-  void check_rtc_time_valid_();
-  void check_ha_connection_();
+  void check_rtc_time_valid_(const ESPTime &now);
+  void check_ha_connection_(bool connected);
   void log_state_flags_();
   
   //============================================================================
@@ -309,7 +748,7 @@ class Schedule : public Component  {
   virtual void initialize_schedule_operation_();
 
  private:
-  int16_t find_current_event_(uint16_t current_time_minutes);
+  int16_t find_current_event_(uint16_t current_time_minutes, uint8_t current_second) const;
   
   //============================================================================
   // TIME AND FORMATTING UTILITIES
@@ -321,7 +760,7 @@ class Schedule : public Component  {
   //============================================================================
   // FORMATTING (Protected for derived classes)
   //============================================================================
-  std::string format_event_time_(uint16_t time_minutes);
+  std::string format_event_time_(uint16_t time_minutes, uint8_t second = 0);
   
   //============================================================================
   // UI UPDATE HELPERS (Protected for StateBasedSchedulable)
@@ -352,7 +791,10 @@ class Schedule : public Component  {
   
   // Preference and configuration
   ArrayPreferenceBase *sched_array_pref_{nullptr};
+  bool combined_storage_{false};
+  bool compressed_storage_{false};
   size_t schedule_max_size_{0};
+  size_t schedule_size_limit_{0};
   std::string ha_schedule_entity_id_;
   
   // Schedule data (private core data)
@@ -362,6 +804,8 @@ class Schedule : public Component  {
   // UI components
   ScheduleSwitchIndicator *switch_indicator_{nullptr};
   text_sensor::TextSensor *current_event_sensor_{nullptr};
+  sensor::Sensor *pref_writes_sensor_{nullptr};
+  sensor::Sensor *pref_writes_skipped_sensor_{nullptr};
   text_sensor::TextSensor *next_event_sensor_{nullptr};
   
   // Status flags
@@ -381,16 +825,62 @@ class Schedule : public Component  {
   uint32_t last_time_check_{0};
   uint32_t last_state_log_time_{0};
   time::RealTimeClock *time_{nullptr};
+  ScheduleTickService *tick_service_{nullptr};
+  ScheduleTick last_tick_{};  // Snapshot of the tick being processed
+  
+  // Deadline-driven wakeups (protected for derived process_tick() access)
+  WheelTimer event_timer_;          // Next transition, or the poll interval in error/INIT states
+  bool event_timer_is_deadline_{false};  // event_timer_ is armed for next_event_raw_ itself (not a poll or cap)
+  bool event_timer_fired_{false};        // event_timer_ expired on the deadline, cleared once the pass re-arms
+  
+  // Clock jump detection reference (wall time and millis() of the previous pass)
+  time_t last_pass_timestamp_{0};
+  uint32_t last_pass_ms_{0};
+  
+  // Day exceptions, allocated on first use (DAYS_PER_EXCEPTION_TABLE DayException values)
+  uint8_t *day_exceptions_{nullptr};
+  uint16_t exception_day_{0xFFFF};   // Table key of the date last looked up
+  DayException active_day_exception_{DAY_EXCEPTION_NONE};
+  bool day_pattern_changed_{false};
+  
+  // Multi-week rotation: patterns are [count, day-relative events...] runs, rotation_days_ holds
+  // one pattern index per day (weeks x 7) and rotation_pattern_offsets_ where each run starts
+  std::vector<std::string> rotation_entity_ids_;
+  uint8_t rotation_week_offset_{0};
+  std::vector<uint16_t> rotation_patterns_;
+  std::vector<uint16_t> rotation_pattern_offsets_;
+  std::vector<uint16_t> rotation_days_;
+  uint8_t active_rotation_week_{0};
+  uint16_t rotation_check_day_{0xFFFF};  // day_of_year of the last rotation check
+  
+  // Solar events (parsed_solar_ collects them during an HA update)
+  SolarTable *solar_table_{nullptr};
+  std::vector<SolarAnchor> solar_anchors_;
+  std::vector<SolarAnchor> parsed_solar_;
+  uint16_t solar_day_{0xFFFF};  // day_of_year the solar times were last resolved for
+  
+  // Next UTC offset change: instant, offset change (+3600 skips an hour, -3600 repeats one)
+  // and the last minute of the day before it in the old offset
+  uint16_t dst_check_day_{0xFFFF};
+  time_t dst_transition_ts_{0};
+  int32_t dst_delta_s_{0};
+  uint16_t dst_hold_minute_{0};
+  
+  std::vector<ScheduleLeadTrigger *> lead_triggers_;
+  
+  size_t stored_table_bytes_{0};  // Bytes of the preference used by the table at the last decode
+  size_t stored_entry_count_{0};  // Exact table length from the storage header, 0 when unknown
+  StorageFootprint storage_footprint_{};
+  bool storage_footprint_valid_{false};
+  uint32_t slot_generation_{0};     // Generation named by the slot pointer
+  ESPPreferenceObject storage_footprint_pref_;
+  ESPPreferenceObject slot_pointer_pref_;
+  bool slot_commit_pending_{false};  // Pointer write queued behind the next preference sync
   
   // Time utilities (protected for derived class access)
-  // Template function must be defined in header
-  uint16_t time_to_minutes_(auto current_now) {
+  uint16_t time_to_minutes_(const ESPTime &current_now) {
     // Calculate current time in minutes from start of week (Monday = 0)
-    // ESPHome: 1=Sunday, 2=Monday, ..., 7=Saturday
-    // We need: Monday=0, ..., Sunday=6
-    uint8_t day_of_week = (current_now.day_of_week + 5) % 7;  // Convert to Monday=0
-    uint16_t current_time_minutes = (day_of_week * 1440) + (current_now.hour * 60) + current_now.minute;
-    return current_time_minutes;
+    return ScheduleTickService::week_minute_of(current_now);
   }
   
   // Event tracking (protected for state machine access)
@@ -416,5 +906,30 @@ class Schedule : public Component  {
 };
 
 
+/**
+ * ScheduleLeadTrigger - on_before_event automation
+ *
+ * Fires lead seconds before the schedule's next event (optionally only ON or OFF
+ * transitions). Its timer is re-armed from the next-event deadline on every pass,
+ * so it follows schedule updates, clock jumps and DST like the event itself.
+ */
+class ScheduleLeadTrigger : public Trigger<> {
+ public:
+  ScheduleLeadTrigger(Schedule *parent, uint32_t lead_s, LeadTriggerFilter filter)
+      : lead_s_(lead_s), filter_(filter) {
+    parent->add_lead_trigger(this);
+  }
+  uint32_t get_lead() const { return this->lead_s_; }
+  LeadTriggerFilter get_filter() const { return this->filter_; }
+
+ protected:
+  friend class Schedule;
+  uint32_t lead_s_;
+  LeadTriggerFilter filter_;
+  WheelTimer timer_;
+  time_t target_ts_{0};     // Event the timer is armed for
+  time_t fired_for_ts_{0};  // Event the trigger last fired for
+};
+
 } // namespace schedule
 } // namespace esphome
\ No newline at end of file
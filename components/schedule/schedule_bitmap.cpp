@@ -0,0 +1,117 @@
+#include "schedule_bitmap.h"
+#include "schedule_encoding.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace schedule {
+
+void WeekBitmap::clear() { std::memset(this->bits_, 0, BYTES); }
+
+void WeekBitmap::set_range(uint16_t from, uint16_t to) {
+  if (from >= MINUTES_PER_WEEK) {
+    return;
+  }
+  if (to > MINUTES_PER_WEEK) {
+    to = MINUTES_PER_WEEK;
+  }
+  // A range ending before it starts wraps past the end of the week
+  if (to < from) {
+    this->set_range(0, to);
+    to = MINUTES_PER_WEEK;
+  }
+  for (uint16_t minute = from; minute < to;) {
+    // Fill whole bytes when aligned, single bits at the edges
+    if ((minute & 7) == 0 && minute + 8 <= to) {
+      this->bits_[minute >> 3] = 0xFF;
+      minute += 8;
+    } else {
+      this->bits_[minute >> 3] |= (1u << (minute & 7));
+      minute++;
+    }
+  }
+}
+
+void WeekBitmap::from_table(const std::vector<uint16_t> &table) {
+  this->clear();
+  for (size_t i = 0; i + 1 < table.size(); i += 2) {
+    if (table[i] == 0xFFFF && table[i + 1] == 0xFFFF) {
+      break;
+    }
+    if ((table[i] & SWITCH_STATE_BIT) == 0) {
+      continue;
+    }
+    this->set_range(table[i] & TIME_MASK, table[i + 1] & TIME_MASK);
+  }
+}
+
+void WeekBitmap::to_table(std::vector<uint16_t> &table) const {
+  table.clear();
+  // State at the end of the week decides whether Monday 00:00 is a transition
+  bool previous = this->test(MINUTES_PER_WEEK - 1);
+  for (uint16_t minute = 0; minute < MINUTES_PER_WEEK;) {
+    // Skip whole bytes that hold no transition
+    if ((minute & 7) == 0 && this->bits_[minute >> 3] == (previous ? 0xFF : 0x00)) {
+      minute += 8;
+      continue;
+    }
+    bool current = this->test(minute);
+    if (current != previous) {
+      table.push_back(current ? (minute | SWITCH_STATE_BIT) : minute);
+      previous = current;
+    }
+    minute++;
+  }
+  // Always on: a single ON event that repeats every week
+  if (table.empty() && previous) {
+    table.push_back(SWITCH_STATE_BIT);
+  }
+  table.push_back(0xFFFF);
+  table.push_back(0xFFFF);
+  table.shrink_to_fit();
+}
+
+size_t WeekBitmap::encode_rle(uint8_t *buf, size_t capacity) const {
+  size_t pos = 0;
+  bool state = false;
+  uint16_t run = 0;
+  for (uint16_t minute = 0; minute <= MINUTES_PER_WEEK; minute++) {
+    // The extra iteration past the end of the week flushes the final run
+    if (minute == MINUTES_PER_WEEK || this->test(minute) != state) {
+      if (pos + 2 > capacity) {
+        return 0;
+      }
+      buf[pos++] = run & 0xFF;
+      buf[pos++] = run >> 8;
+      state = !state;
+      run = 0;
+    }
+    run++;
+  }
+  return pos;
+}
+
+bool WeekBitmap::decode_rle(const uint8_t *buf, size_t size) {
+  this->clear();
+  uint32_t minute = 0;
+  bool state = false;
+  for (size_t pos = 0; pos + 1 < size; pos += 2) {
+    uint16_t run = buf[pos] | (buf[pos + 1] << 8);
+    if (minute + run > MINUTES_PER_WEEK) {
+      break;
+    }
+    if (state) {
+      this->set_range(minute, minute + run);
+    }
+    minute += run;
+    state = !state;
+    if (minute == MINUTES_PER_WEEK) {
+      return true;
+    }
+  }
+  this->clear();
+  return false;
+}
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace esphome {
+namespace schedule {
+
+/**
+ * WeekBitmap - one bit per minute of the week (Monday 00:00 = bit 0)
+ *
+ * Used by the bitmap storage type: the scheduled ON/OFF state for any minute is a
+ * single bit test, and the stored size is fixed at 1260 bytes regardless of how many
+ * slots the schedule has. The bitmap can be run-length encoded for storage, which
+ * pays off for schedules with few long blocks.
+ *
+ * Run-length format: little-endian uint16_t run lengths, alternating OFF/ON and
+ * starting with OFF at Monday 00:00 (the first run may be 0); runs sum to 10080.
+ */
+class WeekBitmap {
+ public:
+  static constexpr uint16_t MINUTES_PER_WEEK = 10080;
+  static constexpr size_t BYTES = MINUTES_PER_WEEK / 8;
+
+  void clear();
+
+  bool test(uint16_t minute) const {
+    return minute < MINUTES_PER_WEEK && (this->bits_[minute >> 3] & (1u << (minute & 7))) != 0;
+  }
+
+  /** Set every minute in [from, to); to may equal MINUTES_PER_WEEK for end of week */
+  void set_range(uint16_t from, uint16_t to);
+
+  /** Build from a state-based table of [ON, OFF] pairs up to the [0xFFFF, 0xFFFF] terminator */
+  void from_table(const std::vector<uint16_t> &table);
+
+  /** Rebuild an exact-length state-based table (transitions + terminator), sorted by time.
+   * Adjacent and overlapping slots collapse into a single ON block.
+   */
+  void to_table(std::vector<uint16_t> &table) const;
+
+  /** Run-length encode into buf; returns bytes written or 0 if it does not fit */
+  size_t encode_rle(uint8_t *buf, size_t capacity) const;
+  /** Decode a run-length buffer; returns false (bitmap cleared) if the runs do not cover one week */
+  bool decode_rle(const uint8_t *buf, size_t size);
+
+  uint8_t *data() { return this->bits_; }
+  const uint8_t *data() const { return this->bits_; }
+
+ protected:
+  uint8_t bits_[BYTES]{};
+};
+
+}  // namespace schedule
+}  // namespace esphome
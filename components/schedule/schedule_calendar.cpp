@@ -0,0 +1,15 @@
+#include "schedule_calendar.h"
+
+namespace esphome {
+namespace schedule {
+
+uint32_t epoch_week(uint16_t year, uint16_t day_of_year) {
+  // Days from 1 January 1970 to 1 January of the year: 365 per year plus the leap days between
+  auto leap_days_before = [](int32_t y) { return (y - 1) / 4 - (y - 1) / 100 + (y - 1) / 400; };
+  int32_t days = 365 * (year - 1970) + leap_days_before(year) - leap_days_before(1970) + (day_of_year - 1);
+  // 1 January 1970 was a Thursday, so week 1 starts on Monday 5 January
+  return static_cast<uint32_t>(days + 3) / 7;
+}
+
+}  // namespace schedule
+}  // namespace esphome
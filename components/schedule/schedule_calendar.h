@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+namespace schedule {
+
+/** Monday-based weeks since Monday 5 January 1970 of a local date (day_of_year 1-366).
+ * Unlike the ISO week number it never restarts at the new year, so a rotation keeps
+ * alternating across week 52/53 and week 1.
+ */
+uint32_t epoch_week(uint16_t year, uint16_t day_of_year);
+
+/** A UTC offset change (DST start or end, or a timezone rule change) */
+struct OffsetChange {
+  time_t timestamp{0};      // First second in the new offset; 0 when there is no change
+  int32_t delta_s{0};       // New offset minus old offset: positive skips local time, negative repeats it
+  uint16_t hold_minute{0};  // Local minute of day just before the change, in the old offset
+};
+
+/** Find a UTC offset change from two hours before to 26 hours after timestamp.
+ * offset_at(ts) returns local time minus UTC in seconds; it is bisected to the first second
+ * in the new offset (about 17 calls, once per day).
+ */
+template<typename OffsetFn> OffsetChange find_offset_change(time_t timestamp, OffsetFn offset_at) {
+  OffsetChange change;
+  time_t before_ts = timestamp - 2 * 3600;
+  time_t after_ts = timestamp + 26 * 3600;
+  int32_t before = offset_at(before_ts);
+  int32_t after = offset_at(after_ts);
+  if (before == after) {
+    return change;
+  }
+  while (after_ts - before_ts > 1) {
+    time_t mid = before_ts + (after_ts - before_ts) / 2;
+    if (offset_at(mid) == before) {
+      before_ts = mid;
+    } else {
+      after_ts = mid;
+    }
+  }
+  change.timestamp = after_ts;
+  change.delta_s = after - before;
+  uint16_t transition_minute = static_cast<uint16_t>(((after_ts + before) / 60) % 1440);
+  change.hold_minute = (transition_minute + 1439) % 1440;
+  return change;
+}
+
+}  // namespace schedule
+}  // namespace esphome
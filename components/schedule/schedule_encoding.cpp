@@ -0,0 +1,142 @@
+#include "schedule_encoding.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace schedule {
+
+// Bitwise: it runs once per load or save, so no lookup table
+uint32_t crc32(const uint8_t *data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+void write_storage_header(uint8_t *record, size_t size, uint8_t layout, uint16_t entry_count,
+                          uint16_t payload_bytes) {
+  StorageHeader header{};
+  header.magic = STORAGE_HEADER_MAGIC;
+  header.version = STORAGE_FORMAT_VERSION;
+  header.layout = layout;
+  header.entry_count = entry_count;
+  header.payload_bytes = payload_bytes;
+  header.crc = crc32(record + STORAGE_HEADER_BYTES, size - STORAGE_HEADER_BYTES);
+  std::memcpy(record, &header, sizeof(header));
+}
+
+StorageHeaderStatus check_storage_header(const uint8_t *record, size_t size, uint8_t layout,
+                                         StorageHeader &header) {
+  if (size < STORAGE_HEADER_BYTES) {
+    return STORAGE_HEADER_MISSING;
+  }
+  std::memcpy(&header, record, sizeof(header));
+  if (header.magic != STORAGE_HEADER_MAGIC) {
+    return STORAGE_HEADER_MISSING;
+  }
+  if (header.version != STORAGE_FORMAT_VERSION) {
+    return STORAGE_HEADER_BAD_VERSION;
+  }
+  if (header.layout != layout) {
+    return STORAGE_HEADER_BAD_LAYOUT;
+  }
+  if (crc32(record + STORAGE_HEADER_BYTES, size - STORAGE_HEADER_BYTES) != header.crc) {
+    return STORAGE_HEADER_BAD_CRC;
+  }
+  return STORAGE_HEADER_OK;
+}
+
+size_t put_varint(uint8_t *out, size_t pos, size_t capacity, uint32_t value) {
+  do {
+    if (pos >= capacity) {
+      return 0;
+    }
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    out[pos++] = value != 0 ? (byte | 0x80) : byte;
+  } while (value != 0);
+  return pos;
+}
+
+bool get_varint(const uint8_t *in, size_t size, size_t &pos, uint32_t &value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 21 && pos < size; shift += 7) {
+    uint8_t byte = in[pos++];
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t encode_compressed_table(const uint16_t *events, size_t count, bool event_based, uint8_t *buf,
+                               size_t capacity) {
+  if (capacity < 1) {
+    return 0;
+  }
+  buf[0] = COMPRESSED_FORMAT_TAG;
+  size_t pos = put_varint(buf, 1, capacity, count);
+  uint16_t previous = 0;
+  for (size_t i = 0; i < count && pos != 0; ++i) {
+    uint16_t word = events[i];
+    uint16_t minute = word & TIME_MASK;
+    if (minute < previous || word != compressed_word(i, minute, event_based)) {
+      // Runs backwards (a slot wrapping past the end of the week) or has unexpected flags: store it raw
+      if (pos + 4 > capacity) {
+        return 0;
+      }
+      buf[pos++] = 0x80;
+      buf[pos++] = 0x00;
+      buf[pos++] = word & 0xFF;
+      buf[pos++] = word >> 8;
+      continue;
+    }
+    pos = put_varint(buf, pos, capacity, minute - previous);
+    previous = minute;
+  }
+  return pos;
+}
+
+size_t decode_compressed_table(const uint8_t *buf, size_t size, bool event_based, size_t max_entries,
+                               std::vector<uint16_t> &table) {
+  size_t pos = 1;
+  uint32_t count = 0;
+  if (size < 1 || buf[0] != COMPRESSED_FORMAT_TAG || !get_varint(buf, size, pos, count) ||
+      count + 2 > max_entries) {
+    return 0;
+  }
+  table.clear();
+  table.reserve(count + 2);
+  uint16_t previous = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (pos + 1 < size && buf[pos] == 0x80 && buf[pos + 1] == 0x00) {
+      if (pos + 4 > size) {
+        return 0;
+      }
+      table.push_back(buf[pos + 2] | (buf[pos + 3] << 8));
+      pos += 4;
+      continue;
+    }
+    uint32_t delta;
+    if (!get_varint(buf, size, pos, delta)) {
+      return 0;
+    }
+    uint32_t minute = previous + delta;
+    if (minute >= SECONDS_PER_WEEK / 60) {
+      return 0;
+    }
+    previous = static_cast<uint16_t>(minute);
+    table.push_back(compressed_word(i, previous, event_based));
+  }
+  table.push_back(0xFFFF);
+  table.push_back(0xFFFF);
+  return pos;
+}
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace esphome {
+namespace schedule {
+
+// Constants for schedule event encoding
+static constexpr uint16_t SWITCH_STATE_BIT = 0x4000;  // Bit 14: switch state
+static constexpr uint16_t TIME_MASK = 0x3FFF;         // Bits 0-13: time in minutes
+
+// Stored form of a sunrise/sunset-relative time (raw storage only; the runtime table holds the
+// resolved minute): bit 15 set, bit 14 switch state, bits 11-13 day, bit 10 sunset, bits 0-9 offset + 512
+static constexpr uint16_t SOLAR_BIT = 0x8000;
+static constexpr uint16_t SOLAR_DAY_SHIFT = 11;
+static constexpr uint16_t SOLAR_SUNSET_BIT = 0x0400;
+static constexpr uint16_t SOLAR_OFFSET_MASK = 0x03FF;
+static constexpr int16_t SOLAR_OFFSET_BIAS = 512;
+
+// Constants for the optional second-resolution (wide) storage encoding
+static constexpr uint32_t SECONDS_PER_WEEK = 604800;
+static constexpr uint32_t WIDE_STATE_BIT = 0x40000000;  // Bit 30: switch state
+static constexpr uint32_t WIDE_TIME_MASK = 0x000FFFFF;  // Bits 0-19: time in seconds from start of week
+static constexpr uint32_t WIDE_TERMINATOR = 0xFFFFFFFF;
+
+/** Header at the start of every schedule record. The CRC covers every byte after the header,
+ * so a load is one check followed by an exact-length decode of payload_bytes.
+ */
+struct StorageHeader {
+  uint16_t magic;          // STORAGE_HEADER_MAGIC
+  uint8_t version;         // STORAGE_FORMAT_VERSION
+  uint8_t layout;          // Schedule::storage_layout_() of the build that wrote it
+  uint16_t entry_count;    // Table words including the terminator
+  uint16_t payload_bytes;  // Encoded table (and repeat windows) after the header
+  uint32_t crc;
+};
+static_assert(sizeof(StorageHeader) == 12, "STORAGE_HEADER_BYTES in __init__.py must match");
+static constexpr size_t STORAGE_HEADER_BYTES = sizeof(StorageHeader);
+static constexpr uint16_t STORAGE_HEADER_MAGIC = 0x5348;
+static constexpr uint8_t STORAGE_FORMAT_VERSION = 1;
+
+enum StorageHeaderStatus : uint8_t {
+  STORAGE_HEADER_OK = 0,
+  STORAGE_HEADER_MISSING,      // Too short or no magic: a record written before headers existed
+  STORAGE_HEADER_BAD_VERSION,
+  STORAGE_HEADER_BAD_LAYOUT,   // Written with another storage type
+  STORAGE_HEADER_BAD_CRC
+};
+
+/** CRC-32 (IEEE 802.3, reflected) */
+uint32_t crc32(const uint8_t *data, size_t size);
+/** Write the header at the start of a size-byte record whose payload is already in place */
+void write_storage_header(uint8_t *record, size_t size, uint8_t layout, uint16_t entry_count,
+                          uint16_t payload_bytes);
+/** Check the header of a size-byte record; header receives the stored fields when there is one */
+StorageHeaderStatus check_storage_header(const uint8_t *record, size_t size, uint8_t layout,
+                                         StorageHeader &header);
+
+/** Append value as unsigned LEB128 (7 bits per byte, high bit set on every byte but the last).
+ * Returns the position after it, or 0 if it does not fit.
+ */
+size_t put_varint(uint8_t *out, size_t pos, size_t capacity, uint32_t value);
+/** Read an unsigned LEB128 value of up to 21 bits at pos and advance past it */
+bool get_varint(const uint8_t *in, size_t size, size_t &pos, uint32_t &value);
+
+/** Compressed table: [format tag, varint count, tokens...]. A token is the varint of the minutes
+ * since the previous token's time; the state bit follows from the position (ON/OFF alternate in
+ * state-based tables, all events are ON in event-based ones). 0x80 0x00, never produced for a value,
+ * escapes a raw little-endian word that runs backwards or has other flags.
+ */
+static constexpr uint8_t COMPRESSED_FORMAT_TAG = 0xD1;
+
+/** Word a compressed token stands for at table position index */
+inline uint16_t compressed_word(size_t index, uint16_t minute, bool event_based) {
+  bool on = event_based || (index % 2) == 0;
+  return on ? (minute | SWITCH_STATE_BIT) : minute;
+}
+
+/** Encode count events (no terminator); returns bytes written or 0 if it does not fit */
+size_t encode_compressed_table(const uint16_t *events, size_t count, bool event_based, uint8_t *buf,
+                               size_t capacity);
+/** Decode into an exact-length table with terminator; returns bytes consumed or 0 if the buffer is
+ * not a valid compressed table of at most max_entries words (table contents are then undefined)
+ */
+size_t decode_compressed_table(const uint8_t *buf, size_t size, bool event_based, size_t max_entries,
+                               std::vector<uint16_t> &table);
+
+}  // namespace schedule
+}  // namespace esphome
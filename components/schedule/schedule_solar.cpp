@@ -0,0 +1,44 @@
+#include "schedule_solar.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace schedule {
+
+int16_t SolarTable::sun_utc_minute(uint16_t day_of_year, bool sunset) {
+  if (this->minutes_ == nullptr) {
+    this->compute_();
+  }
+  if (day_of_year < 1 || day_of_year > DAYS) {
+    day_of_year = 1;
+  }
+  return this->minutes_[(day_of_year - 1) * 2 + (sunset ? 1 : 0)];
+}
+
+void SolarTable::compute_() {
+  this->minutes_ = new int16_t[DAYS * 2];
+  const float deg = M_PI / 180.0f;
+  float latitude = this->latitude_ * deg;
+  for (uint16_t day = 0; day < DAYS; day++) {
+    // Fractional year at noon, then the equation of time (minutes) and solar declination
+    float gamma = 2.0f * M_PI / 365.0f * day;
+    float eqtime = 229.18f * (0.000075f + 0.001868f * cosf(gamma) - 0.032077f * sinf(gamma) -
+                              0.014615f * cosf(2 * gamma) - 0.040849f * sinf(2 * gamma));
+    float decl = 0.006918f - 0.399912f * cosf(gamma) + 0.070257f * sinf(gamma) - 0.006758f * cosf(2 * gamma) +
+                 0.000907f * sinf(2 * gamma) - 0.002697f * cosf(3 * gamma) + 0.00148f * sinf(3 * gamma);
+    float cos_hour_angle = cosf(90.833f * deg) / (cosf(latitude) * cosf(decl)) - tanf(latitude) * tanf(decl);
+    // Clamp for polar night (> 1) and polar day (< -1)
+    if (cos_hour_angle > 1.0f) {
+      cos_hour_angle = 1.0f;
+    } else if (cos_hour_angle < -1.0f) {
+      cos_hour_angle = -1.0f;
+    }
+    float hour_angle = acosf(cos_hour_angle) / deg;
+    float noon = 720.0f - 4.0f * this->longitude_ - eqtime;
+    this->minutes_[day * 2] = static_cast<int16_t>(lroundf(noon - 4.0f * hour_angle));
+    this->minutes_[day * 2 + 1] = static_cast<int16_t>(lroundf(noon + 4.0f * hour_angle));
+  }
+}
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace esphome {
+namespace schedule {
+
+/**
+ * SolarTable - sunrise and sunset for every day of the year at one location
+ *
+ * Computed once on first use (366 days, NOAA approximation with the standard -0.833 degree
+ * horizon) and shared by every schedule at the same coordinates, so resolving a solar event
+ * is a table lookup instead of trigonometry. Times are minutes from UTC midnight and may fall
+ * outside 0-1439 for locations far from Greenwich; the caller applies the local offset.
+ * Polar day and night clamp to sunrise = sunset - 1440 and sunrise = sunset = solar noon.
+ */
+class SolarTable {
+ public:
+  static constexpr uint16_t DAYS = 366;
+
+  SolarTable(float latitude, float longitude) : latitude_(latitude), longitude_(longitude) {}
+
+  /** Sunrise or sunset for a day of the year (1-366) in minutes from UTC midnight */
+  int16_t sun_utc_minute(uint16_t day_of_year, bool sunset);
+
+  float get_latitude() const { return this->latitude_; }
+  float get_longitude() const { return this->longitude_; }
+
+ protected:
+  void compute_();
+
+  float latitude_;
+  float longitude_;
+  // [sunrise, sunset] per day of year, allocated by compute_()
+  int16_t *minutes_{nullptr};
+};
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,144 @@
+#include "schedule_tick_service.h"
+#include "schedule.h"
+#include "array_preference.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/api/api_server.h"
+#include <algorithm>
+
+namespace esphome {
+namespace schedule {
+
+static const char *const TAG = "schedule.tick";
+
+void ScheduleTickService::register_schedule(Schedule *schedule) {
+  this->schedules_.push_back(schedule);
+  this->due_.reserve(this->schedules_.size());
+  this->processing_.reserve(this->schedules_.size());
+  schedule->set_tick_service(this);
+}
+
+void ScheduleTickService::mark_due(Schedule *schedule) {
+  if (std::find(this->due_.begin(), this->due_.end(), schedule) == this->due_.end()) {
+    this->due_.push_back(schedule);
+  }
+}
+
+void ScheduleTickService::limit_sync_delay(uint32_t quiet_ms, uint32_t max_delay_ms) {
+  if (!this->sync_delay_configured_) {
+    this->sync_delay_ms_ = quiet_ms;
+    this->max_sync_delay_ms_ = max_delay_ms;
+    this->sync_delay_configured_ = true;
+    return;
+  }
+  if (quiet_ms != this->sync_delay_ms_ || max_delay_ms != this->max_sync_delay_ms_) {
+    ESP_LOGW(TAG, "Schedules configure different preference sync delays; using the shortest");
+  }
+  this->sync_delay_ms_ = std::min(this->sync_delay_ms_, quiet_ms);
+  this->max_sync_delay_ms_ = std::min(this->max_sync_delay_ms_, max_delay_ms);
+}
+
+void ScheduleTickService::request_pref_sync(ArrayPreferenceBase *pref) {
+  uint32_t now = millis();
+  if (this->dirty_prefs_.empty()) {
+    this->first_dirty_ms_ = now;
+  }
+  this->last_dirty_ms_ = now;
+  if (std::find(this->dirty_prefs_.begin(), this->dirty_prefs_.end(), pref) == this->dirty_prefs_.end()) {
+    this->dirty_prefs_.push_back(pref);
+  }
+  if (this->max_sync_delay_ms_ == 0) {
+    this->flush_pref_sync();
+  }
+}
+
+void ScheduleTickService::after_pref_sync(std::function<void()> &&callback) {
+  this->after_sync_.push_back(std::move(callback));
+  if (this->dirty_prefs_.empty()) {
+    // Everything saved so far is already on flash
+    this->flush_pref_sync();
+  }
+}
+
+void ScheduleTickService::flush_pref_sync() {
+  if (!this->dirty_prefs_.empty()) {
+    // One sync commits every record saved since the last one
+    global_preferences->sync();
+    for (auto *pref : this->dirty_prefs_) {
+      pref->mark_synced();
+    }
+    this->sync_count_++;
+    ESP_LOGD(TAG, "Synced %u preference record(s) in one commit", static_cast<unsigned>(this->dirty_prefs_.size()));
+    this->dirty_prefs_.clear();
+  }
+  if (this->after_sync_.empty()) {
+    return;
+  }
+  // Second phase: writes that may only land once the records above are on flash
+  std::vector<std::function<void()>> callbacks;
+  callbacks.swap(this->after_sync_);
+  for (auto &callback : callbacks) {
+    callback();
+  }
+  global_preferences->sync();
+  this->sync_count_++;
+}
+
+const ScheduleTick &ScheduleTickService::capture_tick() {
+  this->tick_.millis = millis();
+  if (this->time_ != nullptr) {
+    this->tick_.now = this->time_->now();
+    this->tick_.time_valid = this->tick_.now.is_valid();
+  } else {
+    this->tick_.time_valid = false;
+  }
+  this->tick_.week_minute = this->tick_.time_valid ? week_minute_of(this->tick_.now) : 0;
+  this->tick_.api_connected = api::global_api_server != nullptr && api::global_api_server->is_connected();
+  return this->tick_;
+}
+
+void ScheduleTickService::setup() { this->last_tick_ms_ = millis(); }
+
+void ScheduleTickService::loop() {
+  // Advance the wheel once per elapsed second; expired timers queue their schedule.
+  // A stalled loop (e.g. during OTA) catches up here one O(1) step at a time.
+  uint32_t now = millis();
+  while (now - this->last_tick_ms_ >= TICK_INTERVAL_MS) {
+    this->last_tick_ms_ += TICK_INTERVAL_MS;
+    this->wheel_.advance();
+  }
+
+  // Flush deferred preference saves once they go quiet, or when the oldest reaches the maximum delay
+  if (!this->dirty_prefs_.empty() && (now - this->last_dirty_ms_ >= this->sync_delay_ms_ ||
+                                      now - this->first_dirty_ms_ >= this->max_sync_delay_ms_)) {
+    this->flush_pref_sync();
+  }
+
+  if (this->due_.empty()) {
+    return;
+  }
+
+  // Only capture the wall-time snapshot when at least one schedule is due
+  this->capture_tick();
+  this->processing_.swap(this->due_);
+  for (auto *schedule : this->processing_) {
+    schedule->process_tick(this->tick_);
+  }
+  this->processing_.clear();
+}
+
+void ScheduleTickService::dump_config() {
+  ESP_LOGCONFIG(TAG,
+                "Schedule Tick Service:\n"
+                "  Registered Schedules: %u\n"
+                "  Armed Timers: %u\n"
+                "  Tick Interval: %u ms\n"
+                "  Preference Sync Delay: %u ms (max %u ms)",
+                static_cast<unsigned>(this->schedules_.size()),
+                static_cast<unsigned>(this->wheel_.armed_count()),
+                static_cast<unsigned>(TICK_INTERVAL_MS),
+                static_cast<unsigned>(this->sync_delay_ms_),
+                static_cast<unsigned>(this->max_sync_delay_ms_));
+}
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/time/real_time_clock.h"
+#include "schedule_timer_wheel.h"
+#include <functional>
+#include <vector>
+
+namespace esphome {
+namespace schedule {
+
+// Forward declarations
+class Schedule;
+class ArrayPreferenceBase;
+
+/** Snapshot of wall time and connection state, computed once per tick and shared by all schedules */
+struct ScheduleTick {
+  uint32_t millis{0};        // millis() at capture
+  ESPTime now{};             // Local wall time
+  uint16_t week_minute{0};   // Minutes from start of week (Monday 00:00 = 0)
+  bool time_valid{false};    // RTC has a valid time
+  bool api_connected{false}; // Home Assistant API has a connected client
+};
+
+/**
+ * ScheduleTickService - device-wide tick shared by every schedule
+ *
+ * Owns a TimerWheel that every schedule arms with its next transition (and any
+ * temporary mode expiry). Each second the wheel advances once; only timers that
+ * expire queue their schedule, and only queued schedules receive the shared
+ * ScheduleTick snapshot. Idle schedules cost nothing per tick, so the main loop
+ * does not grow with the number of schedules on the device.
+ *
+ * It also owns the deferred preference sync: schedule and data sensor records are
+ * saved without syncing, and one sync flushes every dirty record once saves have
+ * been quiet for the sync delay, or at the latest after the maximum sync delay.
+ *
+ * Created automatically by the platform code generation (one per device).
+ */
+class ScheduleTickService : public Component {
+ public:
+  static constexpr uint32_t TICK_INTERVAL_MS = 1000;
+  static constexpr uint32_t DEFAULT_SYNC_DELAY_MS = 1000;
+  static constexpr uint32_t DEFAULT_MAX_SYNC_DELAY_MS = 10000;
+
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+  void register_schedule(Schedule *schedule);
+
+  /** Queue a schedule to be processed on the next loop() call (trigger or expired timer) */
+  void mark_due(Schedule *schedule);
+  
+  /** Arm a schedule timer to expire delay_s seconds from now (O(1)) */
+  void arm_timer(WheelTimer *timer, uint32_t delay_s) { this->wheel_.arm(timer, delay_s); }
+  void cancel_timer(WheelTimer *timer) { this->wheel_.cancel(timer); }
+
+  /** Set the deferred sync window. The first schedule's values replace the defaults, so they may be
+   * longer; with several schedules the shortest configured values win. A max_delay_ms of 0 syncs on every save.
+   */
+  void limit_sync_delay(uint32_t quiet_ms, uint32_t max_delay_ms);
+  /** Mark a preference record dirty; the sync runs from loop() once saves go quiet */
+  void request_pref_sync(ArrayPreferenceBase *pref);
+  /** Run callback once every record saved so far is on flash, then sync what it saved. Used for
+   * the slot pointer of an A/B update, which must never reach flash before the slot it names.
+   */
+  void after_pref_sync(std::function<void()> &&callback);
+  /** Sync all dirty records now (also run on shutdown) */
+  void flush_pref_sync();
+  uint32_t get_pref_sync_count() const { return this->sync_count_; }
+
+  /** Last snapshot fanned out to the schedules */
+  const ScheduleTick &get_last_tick() const { return this->tick_; }
+
+  /** Capture a fresh snapshot (also used by schedules during setup) */
+  const ScheduleTick &capture_tick();
+
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  void on_shutdown() override { this->flush_pref_sync(); }
+  float get_setup_priority() const override { return setup_priority::LATE; }
+
+  /** Convert local wall time to minutes from start of week (Monday = 0) */
+  static uint16_t week_minute_of(const ESPTime &now) {
+    // ESPHome: 1=Sunday, 2=Monday, ..., 7=Saturday
+    // We need: Monday=0, ..., Sunday=6
+    uint8_t day_of_week = (now.day_of_week + 5) % 7;
+    return (day_of_week * 1440) + (now.hour * 60) + now.minute;
+  }
+
+ protected:
+  time::RealTimeClock *time_{nullptr};
+  std::vector<Schedule *> schedules_;
+  std::vector<Schedule *> due_;         // Schedules queued for the next loop()
+  std::vector<Schedule *> processing_;  // Swapped with due_ so callbacks can queue for the next pass
+  TimerWheel wheel_;
+  ScheduleTick tick_{};
+  uint32_t last_tick_ms_{0};
+  std::vector<ArrayPreferenceBase *> dirty_prefs_;  // Saved since the last sync
+  std::vector<std::function<void()>> after_sync_;   // Pointer writes waiting for the next sync
+  uint32_t first_dirty_ms_{0};
+  uint32_t last_dirty_ms_{0};
+  uint32_t sync_delay_ms_{DEFAULT_SYNC_DELAY_MS};
+  uint32_t max_sync_delay_ms_{DEFAULT_MAX_SYNC_DELAY_MS};
+  bool sync_delay_configured_{false};  // Defaults apply until the first schedule sets the window
+  uint32_t sync_count_{0};
+};
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,94 @@
+#include "schedule_timer_wheel.h"
+
+namespace esphome {
+namespace schedule {
+
+void TimerWheel::arm(WheelTimer *timer, uint32_t delay_ticks) {
+  if (timer->is_armed()) {
+    this->unlink_(timer);
+  }
+  if (delay_ticks == 0) {
+    delay_ticks = 1;
+  } else if (delay_ticks > MAX_DELAY) {
+    delay_ticks = MAX_DELAY;
+  }
+  timer->expiry = this->current_tick_ + delay_ticks;
+  this->link_(timer);
+}
+
+void TimerWheel::cancel(WheelTimer *timer) {
+  if (timer->is_armed()) {
+    this->unlink_(timer);
+  }
+}
+
+void TimerWheel::advance() {
+  uint32_t tick = ++this->current_tick_;
+
+  // At each level boundary pull the matching upper slot down, top level first,
+  // so timers cascaded from level 3 are redistributed again by level 2 and 1
+  for (uint8_t level = LEVELS - 1; level >= 1; level--) {
+    uint8_t shift = SLOT_BITS * level;
+    if ((tick & ((1u << shift) - 1)) == 0) {
+      this->cascade_(level, (tick >> shift) & SLOT_MASK);
+    }
+  }
+
+  // Detach the due slot first so callbacks can safely re-arm their own timer
+  WheelTimer *due = this->slots_[0][tick & SLOT_MASK];
+  if (due != nullptr) {
+    due->pprev = &due;
+  }
+  this->slots_[0][tick & SLOT_MASK] = nullptr;
+  while (due != nullptr) {
+    WheelTimer *timer = due;
+    this->unlink_(timer);
+    if (timer->callback) {
+      timer->callback();
+    }
+  }
+}
+
+void TimerWheel::link_(WheelTimer *timer) {
+  // Pick the lowest level whose span still covers the remaining delay
+  uint32_t delta = timer->expiry - this->current_tick_;
+  uint8_t level = 0;
+  while (level < LEVELS - 1 && delta >= (1u << (SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+  WheelTimer **head = &this->slots_[level][(timer->expiry >> (SLOT_BITS * level)) & SLOT_MASK];
+
+  timer->next = *head;
+  if (timer->next != nullptr) {
+    timer->next->pprev = &timer->next;
+  }
+  timer->pprev = head;
+  *head = timer;
+  this->armed_count_++;
+}
+
+void TimerWheel::unlink_(WheelTimer *timer) {
+  *timer->pprev = timer->next;
+  if (timer->next != nullptr) {
+    timer->next->pprev = timer->pprev;
+  }
+  timer->next = nullptr;
+  timer->pprev = nullptr;
+  this->armed_count_--;
+}
+
+void TimerWheel::cascade_(uint8_t level, uint32_t index) {
+  WheelTimer *pending = this->slots_[level][index];
+  if (pending != nullptr) {
+    pending->pprev = &pending;
+  }
+  this->slots_[level][index] = nullptr;
+  while (pending != nullptr) {
+    WheelTimer *timer = pending;
+    this->unlink_(timer);
+    this->link_(timer);
+  }
+}
+
+}  // namespace schedule
+}  // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace esphome {
+namespace schedule {
+
+/** Intrusive timer node, owned by whoever arms it (the wheel never allocates)
+ *
+ * The callback is set once by the owner; arming and cancelling only relink the node.
+ */
+struct WheelTimer {
+  std::function<void()> callback;
+  uint32_t expiry{0};             // Absolute wheel tick (seconds)
+  WheelTimer *next{nullptr};
+  WheelTimer **pprev{nullptr};    // Address of the pointer that links to this node, nullptr when idle
+
+  bool is_armed() const { return this->pprev != nullptr; }
+};
+
+/**
+ * TimerWheel - hierarchical timing wheel with 1 second resolution
+ *
+ * Four levels of 64 slots cover 64^4 seconds (~194 days), far beyond the one-week
+ * horizon of a schedule. Arming, cancelling and firing a timer are O(1); timers in
+ * the upper levels are cascaded down once per 64^level ticks, so the work done per
+ * tick does not depend on how many schedules are registered.
+ */
+class TimerWheel {
+ public:
+  static constexpr uint8_t LEVELS = 4;
+  static constexpr uint8_t SLOT_BITS = 6;
+  static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+  static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+  static constexpr uint32_t MAX_DELAY = (1u << (SLOT_BITS * LEVELS)) - 1;
+
+  /** Arm (or re-arm) a timer to fire delay_ticks from now; a delay of 0 fires on the next tick */
+  void arm(WheelTimer *timer, uint32_t delay_ticks);
+  /** Disarm a timer; harmless if it is not armed */
+  void cancel(WheelTimer *timer);
+  /** Advance one tick and fire every timer that expires on it */
+  void advance();
+
+  uint32_t now() const { return this->current_tick_; }
+  size_t armed_count() const { return this->armed_count_; }
+
+ protected:
+  void link_(WheelTimer *timer);
+  void unlink_(WheelTimer *timer);
+  void cascade_(uint8_t level, uint32_t index);
+
+  WheelTimer *slots_[LEVELS][SLOTS]{};
+  uint32_t current_tick_{0};
+  size_t armed_count_{0};
+};
+
+}  // namespace schedule
+}  // namespace esphome
@@ -1,6 +1,9 @@
 #include "state_based_schedulable.h"
 #include "schedule_state_mode_select.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace esphome {
 namespace schedule {
 
@@ -39,6 +42,9 @@ void StateBasedSchedulable::on_mode_changed(const std::string &mode) {
   }
   
   ESP_LOGD(TAG, "Current mode enum set to: %d", this->current_mode_);
+  
+  // Apply the new mode immediately instead of waiting for the next event deadline
+  this->request_wakeup_();
 }
 
 void StateBasedSchedulable::on_schedule_empty_changed(bool is_empty) {
@@ -123,6 +129,20 @@ int StateBasedSchedulable::get_state_after_mode_reset_(bool event_on) {
   return event_on ? STATE_AUTO_ON : STATE_AUTO_OFF;
 }
 
+// Return from a temporary mode to auto when its own duration has elapsed
+void StateBasedSchedulable::check_temporary_mode_expiry_() {
+  if (!this->mode_timer_expired_) {
+    return;
+  }
+  this->mode_timer_expired_ = false;
+  if (this->current_mode_ != SCHEDULE_MODE_EARLY_OFF && this->current_mode_ != SCHEDULE_MODE_BOOST_ON) {
+    return;
+  }
+  this->current_mode_ = SCHEDULE_MODE_AUTO;
+  this->set_mode_option(this->current_mode_);
+  ESP_LOGD(TAG, "Temporary mode duration elapsed, reset to AUTO mode");
+}
+
 //==============================================================================
 // OVERRIDDEN BASE CLASS METHODS
 //==============================================================================
@@ -131,17 +151,13 @@ void StateBasedSchedulable::advance_to_next_event_() {
   // Call base class implementation to handle common event advancement
   Schedule::advance_to_next_event_();
   
-  // Update event switch state based on current event
-  this->event_switch_state_ = (this->current_event_raw_ & SWITCH_STATE_BIT) != 0;
+  // Update event switch state based on current event (held OFF on a day-off exception)
+  this->event_switch_state_ = (this->current_event_raw_ & SWITCH_STATE_BIT) != 0 && !this->is_day_off_();
 }
 
 void StateBasedSchedulable::check_and_advance_events_() {
-  // Get current time in minutes
-  auto now_time = this->time_->now();
-  uint16_t current_time_minutes = this->time_to_minutes_(now_time);
-  
   // Check if we should advance to next event
-  if (!this->should_advance_to_next_event_(current_time_minutes)) {
+  if (!this->is_next_event_due_(this->tick_week_second_())) {
     return;
   }
   
@@ -166,9 +182,12 @@ void StateBasedSchedulable::initialize_schedule_operation_() {
   // Call base class implementation for common initialization
   Schedule::initialize_schedule_operation_();
   
-  // Determine if current event is an "on" or "off" event
+  // Determine if current event is an "on" or "off" event (a single bit test with bitmap storage)
   bool in_event = (this->current_event_raw_ & SWITCH_STATE_BIT) != 0;
-  this->event_switch_state_ = in_event;
+  if (this->week_bitmap_ != nullptr && this->last_tick_.time_valid) {
+    in_event = this->week_bitmap_->test(this->last_tick_.week_minute);
+  }
+  this->event_switch_state_ = in_event && !this->is_day_off_();
   
   // Initialize last_on_value_ for each data sensor by searching backwards for the most recent ON event
   this->initialize_sensor_last_on_values_(this->current_event_index_);
@@ -182,84 +201,65 @@ void StateBasedSchedulable::initialize_schedule_operation_() {
   ESP_LOGD(TAG, "State-based initialization complete, state: %d", this->current_state_);
 }
 
+void StateBasedSchedulable::resync_after_clock_jump_(int32_t jump_s) {
+  int16_t old_index = this->current_event_index_;
+  
+  // Re-seek and re-derive the state from the new current event
+  Schedule::resync_after_clock_jump_(jump_s);
+  
+  // Temporary modes end at the next schedule event, so a forward jump across one ends them too
+  bool crossed_event = jump_s > 0 && (old_index != this->current_event_index_ ||
+                                      static_cast<uint32_t>(jump_s) >= SECONDS_PER_WEEK);
+  if (crossed_event && this->should_reset_to_auto_(this->current_state_, this->event_switch_state_)) {
+    this->current_mode_ = SCHEDULE_MODE_AUTO;
+    this->current_state_ = this->get_state_after_mode_reset_(this->event_switch_state_);
+    this->set_mode_option(this->current_mode_);
+    ESP_LOGD(TAG, "Clock jump crossed a schedule event, temporary mode reset to AUTO");
+  }
+}
+
 // Initialize last_on_value_ for each data sensor by finding the most recent ON event
 void StateBasedSchedulable::initialize_sensor_last_on_values_(int16_t current_event_index) {
     ESP_LOGV(TAG, "Initializing sensor last_on_value_ from schedule history");
     
-    // Search backwards from current event to find the most recent ON event
-    // Start from current event and work backwards
-    int16_t search_index = current_event_index;
-    
-    // If current event is an ON event, use it
-    if ((this->schedule_times_in_minutes_[search_index] & SWITCH_STATE_BIT) != 0) {
-        ESP_LOGV(TAG, "Current event is ON, using it for last_on_value_ initialization");
-        uint16_t data_index = search_index / 2;
-        for (auto *sensor : this->data_sensors_) {
-            float value = sensor->get_sensor_value(data_index);
-            sensor->set_last_on_value(value);
-            ESP_LOGV(TAG, "Sensor '%s' last_on_value_ initialized to %.2f from current ON event at index %d",
-                     sensor->get_label().c_str(), value, search_index);
-        }
+    if (current_event_index < 0 || this->schedule_event_count_ == 0) {
+        ESP_LOGW(TAG, "No current event, cannot initialize last_on_value_");
         return;
     }
     
-    // Current event is OFF, search backwards for previous ON event
-    search_index--;
-    
-    // Search backwards through this week's schedule
-    while (search_index >= 0) {
-        uint16_t event_raw = this->schedule_times_in_minutes_[search_index];
-        
-        // Check if this is an ON event
-        if ((event_raw & SWITCH_STATE_BIT) != 0) {
-            ESP_LOGV(TAG, "Found previous ON event at index %d", search_index);
-            uint16_t data_index = search_index / 2;
-            for (auto *sensor : this->data_sensors_) {
-                float value = sensor->get_sensor_value(data_index);
-                sensor->set_last_on_value(value);
-                ESP_LOGV(TAG, "Sensor '%s' last_on_value_ initialized to %.2f from ON event at index %d",
-                         sensor->get_label().c_str(), value, search_index);
-            }
-            return;
+    // Search backwards from the current event using the per-day bucket index.
+    // Step 0 is the current day up to the current event, steps 1-6 are the previous days
+    // (empty days are skipped without scanning) and step 7 is the rest of the current
+    // day from the previous week.
+    uint8_t start_day = std::min<uint16_t>((this->schedule_times_in_minutes_[current_event_index] & TIME_MASK) / 1440, 6);
+    for (uint8_t step = 0; step <= 7; ++step) {
+        uint8_t day = (start_day + 7 - (step % 7)) % 7;
+        size_t first, last;
+        this->get_day_event_range(day, first, last);
+        if (step == 0) {
+            last = current_event_index + 1;
+        } else if (step == 7) {
+            first = current_event_index + 1;
         }
-        search_index--;
-    }
-    
-    // No ON event found in current week, search from end of schedule backwards (previous week rollback)
-    ESP_LOGV(TAG, "No ON event found in current week, searching from end of schedule");
-    
-    // Find the last valid entry in the schedule
-    int16_t last_index = -1;
-    for (size_t i = 0; i < this->schedule_times_in_minutes_.size(); i++) {
-        if (this->schedule_times_in_minutes_[i] == 0xFFFF) {
-            last_index = i - 1;
-            break;
-        }
-    }
-    
-    if (last_index < 0) {
-        ESP_LOGW(TAG, "Could not find end of schedule, cannot initialize last_on_value_");
-        return;
-    }
-    
-    // Search backwards from end of schedule
-    search_index = last_index;
-    while (search_index >= 0) {
-        uint16_t event_raw = this->schedule_times_in_minutes_[search_index];
         
-        // Check if this is an ON event
-        if ((event_raw & SWITCH_STATE_BIT) != 0) {
-            ESP_LOGV(TAG, "Found previous week's ON event at index %d", search_index);
+        for (size_t search_index = last; search_index-- > first;) {
+            // Check if this is an ON event
+            if ((this->schedule_times_in_minutes_[search_index] & SWITCH_STATE_BIT) == 0) {
+                continue;
+            }
+            bool previous_week = static_cast<int16_t>(search_index) > current_event_index;
+            ESP_LOGV(TAG, "Found %s ON event at index %u",
+                     previous_week ? "previous week's" : (step == 0 && static_cast<int16_t>(search_index) == current_event_index) ? "current" : "previous",
+                     static_cast<unsigned>(search_index));
             uint16_t data_index = search_index / 2;
             for (auto *sensor : this->data_sensors_) {
                 float value = sensor->get_sensor_value(data_index);
                 sensor->set_last_on_value(value);
-                ESP_LOGV(TAG, "Sensor '%s' last_on_value_ initialized to %.2f from previous week ON event at index %d",
-                         sensor->get_label().c_str(), value, search_index);
+                ESP_LOGV(TAG, "Sensor '%s' last_on_value_ initialized to %.2f from ON event at index %u",
+                         sensor->get_label().c_str(), value, static_cast<unsigned>(search_index));
             }
             return;
         }
-        search_index--;
     }
     
     // No ON event found in entire schedule
@@ -267,14 +267,65 @@ void StateBasedSchedulable::initialize_sensor_last_on_values_(int16_t current_ev
 }
 
 // Create event string for state-based (ON/OFF format)
-std::string StateBasedSchedulable::create_event_string_(uint16_t event_raw) {
+std::string StateBasedSchedulable::create_event_string_(uint16_t event_raw, int16_t event_index) {
 	uint16_t event_time = event_raw & TIME_MASK;
 	bool event_state = (event_raw & SWITCH_STATE_BIT) != 0;
 	char buffer[32];
-	snprintf(buffer, sizeof(buffer), "%s at %s", event_state ? "ON" : "OFF", this->format_event_time_(event_time).c_str());
+	snprintf(buffer, sizeof(buffer), "%s at %s", event_state ? "ON" : "OFF", this->format_event_time_(event_time, this->event_second_(event_index)).c_str());
 	return std::string(buffer);
 }
 
+//==============================================================================
+// BITMAP STORAGE
+//==============================================================================
+
+// Storage format tag in the first byte of the preference
+static const uint8_t BITMAP_FORMAT_RAW = 0x01;
+static const uint8_t BITMAP_FORMAT_RLE = 0x02;
+
+size_t StateBasedSchedulable::encode_schedule_storage_(uint8_t *buf, size_t capacity) {
+  if (this->week_bitmap_ == nullptr) {
+    return Schedule::encode_schedule_storage_(buf, capacity);
+  }
+  if (capacity < 1) {
+    return 0;
+  }
+  this->week_bitmap_->from_table(this->schedule_times_in_minutes_);
+  
+  // Prefer run-length encoding when enabled and smaller than the raw bitmap
+  if (this->bitmap_run_length_encoded_) {
+    size_t rle_bytes = this->week_bitmap_->encode_rle(buf + 1, std::min(capacity - 1, WeekBitmap::BYTES));
+    if (rle_bytes > 0) {
+      buf[0] = BITMAP_FORMAT_RLE;
+      ESP_LOGD(TAG, "Bitmap stored run-length encoded in %u bytes", static_cast<unsigned>(rle_bytes + 1));
+      return rle_bytes + 1;
+    }
+  }
+  if (capacity < WeekBitmap::BYTES + 1) {
+    return 0;
+  }
+  buf[0] = BITMAP_FORMAT_RAW;
+  std::memcpy(buf + 1, this->week_bitmap_->data(), WeekBitmap::BYTES);
+  return WeekBitmap::BYTES + 1;
+}
+
+bool StateBasedSchedulable::decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) {
+  if (this->week_bitmap_ == nullptr) {
+    return Schedule::decode_schedule_storage_(buf, size, table);
+  }
+  if (size < 1) {
+    return false;
+  }
+  if (buf[0] == BITMAP_FORMAT_RAW && size >= WeekBitmap::BYTES + 1) {
+    std::memcpy(this->week_bitmap_->data(), buf + 1, WeekBitmap::BYTES);
+  } else if (buf[0] != BITMAP_FORMAT_RLE || !this->week_bitmap_->decode_rle(buf + 1, size - 1)) {
+    return false;
+  }
+  this->week_bitmap_->to_table(table);
+  ESP_LOGI(TAG, "Decoded bitmap into %u transitions", static_cast<unsigned>(table.size() - 2));
+  return true;
+}
+
 //==============================================================================
 // STATE MACHINE METHODS
 //==============================================================================
@@ -289,6 +340,16 @@ void StateBasedSchedulable::handle_state_change_() {
   this->processed_state_ = this->current_state_;
   ESP_LOGV(TAG, "Schedule state changed to: %d", this->current_state_);
   
+  // Temporary modes hold an expiry timer only while they are active
+  if (this->current_state_ == STATE_EARLY_OFF || this->current_state_ == STATE_BOOST_ON) {
+    if (this->temporary_mode_duration_s_ > 0) {
+      this->arm_timer_(&this->mode_timer_, this->temporary_mode_duration_s_);
+    }
+  } else {
+    this->cancel_timer_(&this->mode_timer_);
+    this->mode_timer_expired_ = false;
+  }
+  
   // Perform actions based on new state
   switch(this->current_state_) {
     case STATE_TIME_INVALID:
@@ -336,7 +397,7 @@ void StateBasedSchedulable::handle_state_change_() {
       // Early-off mode - turn off until next schedule event
       this->apply_scheduled_state(false);
       this->update_switch_indicator(false);
-      this->display_current_next_events_("Early Off", this->create_event_string_(this->next_event_raw_));
+      this->display_current_next_events_("Early Off", this->create_event_string_(this->next_event_raw_, this->next_event_index_));
       this->set_data_sensors_(this->current_event_index_, false, false);
       break;
       
@@ -344,7 +405,7 @@ void StateBasedSchedulable::handle_state_change_() {
       // Boost mode - turn on until next schedule event
       this->apply_scheduled_state(true);
       this->update_switch_indicator(true);
-      this->display_current_next_events_("Boost On", this->create_event_string_(this->next_event_raw_));
+      this->display_current_next_events_("Boost On", this->create_event_string_(this->next_event_raw_, this->next_event_index_));
       this->set_data_sensors_(this->current_event_index_, true, false);
       break;
       
@@ -353,8 +414,8 @@ void StateBasedSchedulable::handle_state_change_() {
       this->apply_scheduled_state(true);
       this->update_switch_indicator(true);
       this->display_current_next_events_(
-        this->create_event_string_(this->current_event_raw_), 
-        this->create_event_string_(this->next_event_raw_)
+        this->create_event_string_(this->current_event_raw_, this->current_event_index_), 
+        this->create_event_string_(this->next_event_raw_, this->next_event_index_)
       );
       this->set_data_sensors_(this->current_event_index_, true, false);
       break;
@@ -363,10 +424,15 @@ void StateBasedSchedulable::handle_state_change_() {
       // Auto mode - schedule indicates OFF
       this->apply_scheduled_state(false);
       this->update_switch_indicator(false);
-      this->display_current_next_events_(
-        this->create_event_string_(this->current_event_raw_), 
-        this->create_event_string_(this->next_event_raw_)
-      );
+      if (this->is_day_off_()) {
+        // Today's entries are suppressed by a day exception; do not show them as upcoming
+        this->display_current_next_events_("Day Off", "Day Off");
+      } else {
+        this->display_current_next_events_(
+          this->create_event_string_(this->current_event_raw_, this->current_event_index_), 
+          this->create_event_string_(this->next_event_raw_, this->next_event_index_)
+        );
+      }
       this->set_data_sensors_(this->current_event_index_, false, false);
       break;
       
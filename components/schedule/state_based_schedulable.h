@@ -53,6 +53,9 @@ enum ScheduleMode {
  * 
  * Examples: Switch, Climate, Light, Fan
  * 
+ * With bitmap storage the schedule is stored as one bit per minute of the week
+ * (1260 bytes, optionally run-length encoded) and decoded back into transitions.
+ * 
  * Usage in YAML:
  *   switch:
  *     - platform: schedule
@@ -60,16 +63,42 @@ enum ScheduleMode {
  */
 class StateBasedSchedulable : public Schedule {
  public:
-  StateBasedSchedulable() = default;
+  StateBasedSchedulable() {
+    // Temporary modes register their own expiry on the shared timer wheel
+    this->mode_timer_.callback = [this]() {
+      this->mode_timer_expired_ = true;
+      this->request_wakeup_();
+    };
+  }
   
-  /** Returns STORAGE_TYPE_STATE_BASED (default) */
+  /** Returns STORAGE_TYPE_STATE_BASED (default) or STORAGE_TYPE_BITMAP when bitmap storage is enabled */
   ScheduleStorageType get_storage_type() const override {
-    return STORAGE_TYPE_STATE_BASED;
+    return this->week_bitmap_ != nullptr ? STORAGE_TYPE_BITMAP : STORAGE_TYPE_STATE_BASED;
+  }
+  
+  /** Store the schedule as a minute-of-week bitmap instead of [ON, OFF] pairs.
+   * Must be called before set_max_schedule_entries(). Data items are not supported,
+   * as adjacent slots merge into a single block.
+   * @param run_length_encoded store the bitmap run-length encoded
+   */
+  void set_bitmap_storage(bool run_length_encoded) {
+    if (this->week_bitmap_ == nullptr) {
+      this->week_bitmap_ = new WeekBitmap();  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    this->bitmap_run_length_encoded_ = run_length_encoded;
   }
   
-  /** State-based components use the full state machine with modes */
-  void loop() override {
-    uint32_t now = millis();
+  
+  /** State-based components use the full state machine with modes
+   * Runs on the shared tick instead of polling from loop()
+   */
+  void process_tick(const ScheduleTick &tick) override {
+    this->last_tick_ = tick;
+    this->apply_rotation_week_();
+    this->apply_solar_day_();
+    this->apply_day_exception_();
+    this->apply_dst_rules_();
+    uint32_t now = tick.millis;
     
     // Periodic logging every 60 seconds
     if (now - this->last_state_log_time_ >= 60000) {
@@ -79,69 +108,87 @@ class StateBasedSchedulable : public Schedule {
       ESP_LOGV("schedule", "Current mode: %d", this->current_mode_);
     }
 
-    // Normal operation - run every second
-    if (now - this->last_time_check_ >= 1000) {
-      this->last_time_check_ = now;
-      
-      // Check all prerequisites (returns error code)
-      auto prereq_error = this->check_prerequisites_();
-      
-      // Handle prerequisite errors with state transitions
-      if (prereq_error != PREREQ_OK) {
-        // Map prerequisite errors to states
-        if (prereq_error == PREREQ_TIME_INVALID) {
-          if (this->current_state_ != STATE_TIME_INVALID) {
-            ESP_LOGW("schedule", "Time is not valid, schedule operations paused");
-            this->current_state_ = STATE_TIME_INVALID;
-          }
-        } else if (prereq_error == PREREQ_SCHEDULE_INVALID) {
-          if (this->current_state_ != STATE_SCHEDULE_INVALID) {
-            ESP_LOGW("schedule", "Schedule is not valid and Home Assistant not connected");
-            this->current_state_ = STATE_SCHEDULE_INVALID;
-          }
-        } else if (prereq_error == PREREQ_SCHEDULE_EMPTY) {
-          if (this->current_state_ != STATE_SCHEDULE_EMPTY) {
-            ESP_LOGI("schedule", "Schedule is empty, no events to process");
-            this->current_state_ = STATE_SCHEDULE_EMPTY;
-          }
+    // Only called by the tick service when a timer expired or a wakeup was requested;
+    // poll again in a second unless this pass arms the next event deadline
+    this->last_time_check_ = now;
+    this->arm_poll_timer_();
+    
+    // Check all prerequisites (returns error code)
+    auto prereq_error = this->check_prerequisites_();
+    
+    // Handle prerequisite errors with state transitions
+    if (prereq_error != PREREQ_OK) {
+      // Map prerequisite errors to states
+      if (prereq_error == PREREQ_TIME_INVALID) {
+        if (this->current_state_ != STATE_TIME_INVALID) {
+          ESP_LOGW("schedule", "Time is not valid, schedule operations paused");
+          this->current_state_ = STATE_TIME_INVALID;
+        }
+      } else if (prereq_error == PREREQ_SCHEDULE_INVALID) {
+        if (this->current_state_ != STATE_SCHEDULE_INVALID) {
+          ESP_LOGW("schedule", "Schedule is not valid and Home Assistant not connected");
+          this->current_state_ = STATE_SCHEDULE_INVALID;
+        }
+      } else if (prereq_error == PREREQ_SCHEDULE_EMPTY) {
+        if (this->current_state_ != STATE_SCHEDULE_EMPTY) {
+          ESP_LOGI("schedule", "Schedule is empty, no events to process");
+          this->current_state_ = STATE_SCHEDULE_EMPTY;
         }
-        // Handle state change for error states
-        this->handle_state_change_();
-        return;
-      }
-      
-      // Prerequisites OK - transition from error states to INIT if needed
-      if ((this->current_state_ == STATE_TIME_INVALID || 
-           this->current_state_ == STATE_SCHEDULE_INVALID || 
-           this->current_state_ == STATE_SCHEDULE_EMPTY) && 
-          prereq_error == PREREQ_OK) {
-        this->current_state_ = STATE_INIT;
-        ESP_LOGV("schedule", "Prerequisites met, transitioning to INIT state");
-      }
-      
-      // Handle initialization state
-      if (this->current_state_ == STATE_INIT) {
-        this->initialize_schedule_operation_();
-        ESP_LOGI("schedule", "Normal operation, mode = %d State = %d", this->current_mode_, this->current_state_);
-        return;  // Exit to allow next iteration to handle normal operation
-      }
-      
-      // Skip if still in error states
-      if (this->current_state_ == STATE_TIME_INVALID ||
-          this->current_state_ == STATE_SCHEDULE_INVALID ||
-          this->current_state_ == STATE_SCHEDULE_EMPTY) {
-        return;
       }
-      
-      // Update current state based on mode and event state
-      this->current_state_ = this->mode_to_state_(this->current_mode_, this->event_switch_state_);
-      
-      // Handle state changes - this will only process if state differs from processed_state_
+      // Handle state change for error states
       this->handle_state_change_();
-      
-      // Check and advance schedule events if time has reached next event
-      this->check_and_advance_events_();
+      return;
+    }
+    
+    // Prerequisites OK - transition from error states to INIT if needed
+    if ((this->current_state_ == STATE_TIME_INVALID || 
+         this->current_state_ == STATE_SCHEDULE_INVALID || 
+         this->current_state_ == STATE_SCHEDULE_EMPTY) && 
+        prereq_error == PREREQ_OK) {
+      this->current_state_ = STATE_INIT;
+      ESP_LOGV("schedule", "Prerequisites met, transitioning to INIT state");
     }
+    
+    // Handle initialization state
+    if (this->current_state_ == STATE_INIT) {
+      this->initialize_schedule_operation_();
+      ESP_LOGI("schedule", "Normal operation, mode = %d State = %d", this->current_mode_, this->current_state_);
+      return;  // Exit to allow next iteration to handle normal operation
+    }
+    
+    // Skip if still in error states
+    if (this->current_state_ == STATE_TIME_INVALID ||
+        this->current_state_ == STATE_SCHEDULE_INVALID ||
+        this->current_state_ == STATE_SCHEDULE_EMPTY) {
+      return;
+    }
+    
+    // Re-seek in O(log n) instead of stepping event by event if the wall clock jumped
+    int32_t clock_jump_s = this->detect_clock_jump_();
+    if (clock_jump_s != 0) {
+      this->resync_after_clock_jump_(clock_jump_s);
+    } else if (this->take_day_pattern_change_()) {
+      // Today's pattern changed (day exception or rotation week): re-seek
+      this->initialize_schedule_operation_();
+    }
+    
+    // Return a temporary mode to AUTO if its own expiry timer fired
+    this->check_temporary_mode_expiry_();
+    
+    // Update current state based on mode and event state
+    this->current_state_ = this->mode_to_state_(this->current_mode_, this->event_switch_state_);
+    
+    // Handle state changes - this will only process if state differs from processed_state_
+    this->handle_state_change_();
+    
+    // Check and advance schedule events if time has reached next event
+    this->check_and_advance_events_();
+    
+    // Apply any transition now rather than on the next wakeup
+    this->handle_state_change_();
+    
+    // Idle until the next event is due
+    this->arm_event_deadline_();
   }
   
   //============================================================================
@@ -151,6 +198,9 @@ class StateBasedSchedulable : public Schedule {
   void set_mode_option(ScheduleMode mode);
   void on_mode_changed(const std::string &mode);
   
+  /** Maximum time Early Off / Boost On stay active before returning to AUTO (0 = until next event) */
+  void set_temporary_mode_duration(uint32_t seconds) { this->temporary_mode_duration_s_ = seconds; }
+  
   // Logging - state-based format (ON/OFF pairs)
   void log_schedule_data() override;
    
@@ -161,6 +211,15 @@ class StateBasedSchedulable : public Schedule {
   void advance_to_next_event_() override;
   void check_and_advance_events_() override;
   void initialize_schedule_operation_() override;
+  void resync_after_clock_jump_(int32_t jump_s) override;
+  /** Bitmap storage: encode/decode the preference as a (run-length encoded) bitmap */
+  size_t encode_schedule_storage_(uint8_t *buf, size_t capacity) override;
+  bool decode_schedule_storage_(const uint8_t *buf, size_t size, std::vector<uint16_t> &table) override;
+  uint8_t storage_layout_() const override {
+    return this->week_bitmap_ != nullptr ? STORAGE_LAYOUT_BITMAP : Schedule::storage_layout_();
+  }
+  /** Lead triggers fire in AUTO and the temporary modes, not in Manual Off/On or error states */
+  bool lead_triggers_enabled_() const override { return this->current_state_ >= STATE_EARLY_OFF; }
   
   //============================================================================
   // STATE MACHINE METHODS (state-based only)
@@ -171,16 +230,18 @@ class StateBasedSchedulable : public Schedule {
   // STATE MACHINE HELPER METHODS (state-based only)
   //============================================================================
   void initialize_sensor_last_on_values_(int16_t current_event_index);
-  std::string create_event_string_(uint16_t event_raw);
+  std::string create_event_string_(uint16_t event_raw, int16_t event_index);
   int mode_to_state_(ScheduleMode mode, bool event_on);
   bool should_reset_to_auto_(int state, bool event_on);
   int get_state_after_mode_reset_(bool event_on);
+  void check_temporary_mode_expiry_();
   
   /** Force reinitialization after schedule update */
   void force_reinitialize() {
     ESP_LOGD("schedule.state_based", "Forcing reinitialization");
     this->current_state_ = STATE_INIT;
     this->processed_state_ = STATE_INIT;
+    this->request_wakeup_();
   }
   
   /** Update mode select options when schedule empty state changes */
@@ -196,6 +257,15 @@ class StateBasedSchedulable : public Schedule {
   // State machine
   int current_state_{STATE_INIT};
   int processed_state_{STATE_INIT};
+  
+  // Bitmap storage (nullptr for the default [ON, OFF] pair storage)
+  WeekBitmap *week_bitmap_{nullptr};
+  bool bitmap_run_length_encoded_{false};
+  
+  // Temporary mode expiry (armed while Early Off / Boost On is active)
+  WheelTimer mode_timer_;
+  bool mode_timer_expired_{false};
+  uint32_t temporary_mode_duration_s_{0};
 };
 
 } // namespace schedule
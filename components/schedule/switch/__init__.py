@@ -11,6 +11,7 @@ from esphome.const import (
     CONF_ID,
     CONF_NAME,
     CONF_TIME_ID,
+    CONF_LATITUDE,
     ENTITY_CATEGORY_CONFIG,
 )
 
@@ -33,6 +34,37 @@ from .. import (
     ITEM_TYPES,
     ITEM_TYPE_BYTES,
     calculate_schedule_array_size,  # NEW: Helper function for array size calculation
+    register_schedule_tick,
+    register_day_exceptions,
+    CONF_SECOND_RESOLUTION,
+    CONF_COMBINED_STORAGE,
+    CONF_COMPRESSED_STORAGE,
+    validate_compressed_storage,
+    compressed_storage_supported,
+    report_schedule_storage,
+    schedule_record_size,
+    CONF_SCHEDULE_SIZE_LIMIT,
+    SCHEDULE_SIZE_LIMIT_SCHEMA,
+    validate_schedule_size_limit,
+    schedule_size_limit,
+    new_array_preference,
+    CONF_DAY_EXCEPTIONS,
+    DAY_EXCEPTION_SCHEMA,
+    CONF_ROTATION_ENTITY_IDS,
+    ROTATION_SCHEMA,
+    validate_rotation,
+    SOLAR_SCHEMA,
+    validate_solar,
+    register_solar,
+    register_data_sensor_ramp,
+    LEAD_TRIGGER_SCHEMA_STATE_BASED,
+    PREFERENCE_SYNC_SCHEMA,
+    PREFERENCE_WRITES_SCHEMA,
+    register_preference_write_sensors,
+    validate_preference_sync,
+    register_lead_triggers,
+    rotation_weeks,
+    register_rotation,
 )
 
 CODEOWNERS = ["@pebblebed-tech"]
@@ -46,6 +78,11 @@ CONF_CURRENT_EVENT = "current_event"
 CONF_NEXT_EVENT = "next_event"
 CONF_MODE_SELECT = "mode_selector"
 CONF_UPDATE_ON_RECONNECT = "update_schedule_from_ha_on_reconnect"
+CONF_TEMPORARY_MODE_DURATION = "temporary_mode_duration"
+CONF_STORAGE_TYPE = "storage_type"
+
+# Storage formats for the schedule preference
+STORAGE_TYPE_OPTIONS = ["state_based", "bitmap", "bitmap_rle"]
 
 # C++ classes
 ScheduleSwitch = schedule_ns.class_("ScheduleSwitch", esphome_switch.Switch, StateBasedSchedulable)
@@ -68,6 +105,7 @@ CONFIG_SCHEMA = esphome_switch.switch_schema(
     cv.GenerateID(): cv.declare_id(ScheduleSwitch),
     cv.Required(CONF_HA_SCHEDULE_ENTITY_ID): cv.string,
     cv.Optional(CONF_MAX_SCHEDULE_SIZE, default=21): cv.int_,
+    **SCHEDULE_SIZE_LIMIT_SCHEMA,
     cv.Optional(CONF_SCHEDULED_DATA_ITEMS): cv.ensure_list(DATA_SENSOR_SCHEMA_STATE_BASED),
     cv.Required(CONF_UPDATE_BUTTON): cv.maybe_simple_value(
         button.button_schema(
@@ -101,7 +139,39 @@ CONFIG_SCHEMA = esphome_switch.switch_schema(
         cv.requires_component("time"), cv.use_id(time.RealTimeClock)
     ),
     cv.Optional(CONF_UPDATE_ON_RECONNECT, default=False): cv.boolean,
-}).extend(cv.COMPONENT_SCHEMA)
+    cv.Optional(CONF_TEMPORARY_MODE_DURATION): cv.positive_time_period_seconds,
+    cv.Optional(CONF_STORAGE_TYPE, default="state_based"): cv.one_of(*STORAGE_TYPE_OPTIONS, lower=True),
+    cv.Optional(CONF_SECOND_RESOLUTION, default=False): cv.boolean,
+    cv.Optional(CONF_COMBINED_STORAGE, default=False): cv.boolean,
+    cv.Optional(CONF_COMPRESSED_STORAGE, default=False): cv.boolean,
+    cv.Optional(CONF_DAY_EXCEPTIONS): cv.ensure_list(DAY_EXCEPTION_SCHEMA),
+}).extend(ROTATION_SCHEMA).extend(SOLAR_SCHEMA).extend(LEAD_TRIGGER_SCHEMA_STATE_BASED).extend(PREFERENCE_SYNC_SCHEMA).extend(PREFERENCE_WRITES_SCHEMA).extend(cv.COMPONENT_SCHEMA)
+
+
+def validate_storage_type(config):
+    # Bitmap storage merges adjacent slots, so per-entry data items cannot be kept
+    if config[CONF_STORAGE_TYPE] != "state_based" and config.get(CONF_SCHEDULED_DATA_ITEMS):
+        raise cv.Invalid(f"{CONF_SCHEDULED_DATA_ITEMS} are not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    # The bitmap has one bit per minute, so it cannot hold seconds
+    if config[CONF_STORAGE_TYPE] != "state_based" and config[CONF_SECOND_RESOLUTION]:
+        raise cv.Invalid(f"{CONF_SECOND_RESOLUTION} is not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    # The bitmap holds a single week
+    if config[CONF_STORAGE_TYPE] != "state_based" and CONF_ROTATION_ENTITY_IDS in config:
+        raise cv.Invalid(f"{CONF_ROTATION_ENTITY_IDS} is not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    # The compressed format is a delta-encoded ON/OFF table
+    if config[CONF_STORAGE_TYPE] != "state_based" and config[CONF_COMPRESSED_STORAGE]:
+        raise cv.Invalid(f"{CONF_COMPRESSED_STORAGE} is not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    # Solar times are resolved in the ON/OFF table, which the bitmap does not keep
+    if config[CONF_STORAGE_TYPE] != "state_based" and CONF_LATITUDE in config:
+        raise cv.Invalid(f"Solar times are not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    # The bitmap size does not depend on the number of entries, so there is nothing to grow
+    if config[CONF_STORAGE_TYPE] != "state_based" and CONF_SCHEDULE_SIZE_LIMIT in config:
+        raise cv.Invalid(f"{CONF_SCHEDULE_SIZE_LIMIT} is not supported with {CONF_STORAGE_TYPE}: {config[CONF_STORAGE_TYPE]}")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(CONFIG_SCHEMA, validate_storage_type, validate_rotation, validate_solar, validate_compressed_storage,
+                       validate_preference_sync, validate_schedule_size_limit)
 
 async def to_code(config):
     # Create the switch (which extends Schedule)
@@ -110,13 +180,39 @@ async def to_code(config):
     
     # Set up base Schedule properties
     cg.add(var.set_schedule_entity_id(config[CONF_HA_SCHEDULE_ENTITY_ID]))
+    # Storage type must be set before the max size, which depends on it
+    storage_type = config[CONF_STORAGE_TYPE]
+    if storage_type != "state_based":
+        cg.add(var.set_bitmap_storage(storage_type == "bitmap_rle"))
     cg.add(var.set_max_schedule_entries(config[CONF_MAX_SCHEDULE_SIZE]))
+    cg.add(var.set_schedule_size_limit(schedule_size_limit(config)))
+    cg.add(var.set_second_resolution(config[CONF_SECOND_RESOLUTION]))
+    await register_rotation(var, config)
+    await register_solar(var, config)
+    await register_lead_triggers(var, config)
+    await register_preference_write_sensors(var, config)
     
     # Calculate and create array preference for schedule times
-    # ScheduleSwitch is state-based (stores ON/OFF pairs)
-    size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], 'state')
+    # ScheduleSwitch is state-based (stores ON/OFF pairs) unless bitmap storage is selected
+    size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], storage_type, config[CONF_SECOND_RESOLUTION],
+                                         rotation_weeks(config))
+    if storage_type == "state_based" and compressed_storage_supported(config):
+        compressed_size = calculate_schedule_array_size(config[CONF_MAX_SCHEDULE_SIZE], storage_type, compressed=True)
+        report_schedule_storage(config, size, compressed_size)
+        if config[CONF_COMPRESSED_STORAGE]:
+            size = compressed_size
+    cg.add(var.set_compressed_storage(config[CONF_COMPRESSED_STORAGE]))
     # Legacy calculation for reference: size = (config[CONF_MAX_SCHEDULE_SIZE] * 2 * 2) + 4
-    array_pref = cg.RawExpression(f'new esphome::schedule::ArrayPreference<{size}>()')
+    # Storage header, and with combined storage the data sensor columns, share this record
+    size = schedule_record_size(size, config)
+    # The record can grow at runtime to the size needed for schedule_size_limit entries
+    limit = schedule_size_limit(config)
+    limit_size = calculate_schedule_array_size(limit, storage_type, config[CONF_SECOND_RESOLUTION], rotation_weeks(config))
+    if config[CONF_COMPRESSED_STORAGE]:
+        limit_size = calculate_schedule_array_size(limit, storage_type, compressed=True)
+    limit_size = schedule_record_size(limit_size, config, limit)
+    cg.add(var.set_combined_storage(config[CONF_COMBINED_STORAGE]))
+    array_pref = new_array_preference(size, limit_size)
     cg.add(var.sched_add_pref(array_pref))
     
     # Set internal to true by default
@@ -159,9 +255,19 @@ async def to_code(config):
         time_var = await cg.get_variable(config[CONF_TIME_ID])
         cg.add(var.set_time(time_var))
     
+    # Drive the schedule from the shared device-wide tick
+    await register_schedule_tick(var, config)
+    
+    # Holiday / shutdown overrides on top of the weekly schedule
+    await register_day_exceptions(var, config)
+    
     # Set update on reconnect flag
     cg.add(var.set_update_schedule_on_reconnect(config[CONF_UPDATE_ON_RECONNECT]))
     
+    # Optional expiry for Early Off / Boost On (otherwise they last until the next event)
+    if CONF_TEMPORARY_MODE_DURATION in config:
+        cg.add(var.set_temporary_mode_duration(config[CONF_TEMPORARY_MODE_DURATION].total_seconds))
+    
     # Process schedule data items
     if CONF_SCHEDULED_DATA_ITEMS in config:
         for sensor_config in config[CONF_SCHEDULED_DATA_ITEMS]:
@@ -174,7 +280,7 @@ async def to_code(config):
             # Calculate bytes needed for this sensor's data
             bytes_per_item = ITEM_TYPE_BYTES[item_type]
             default_bytes = max_entries * bytes_per_item
-            sensor_array_pref = cg.RawExpression(f'new esphome::schedule::ArrayPreference<{default_bytes}>()')
+            sensor_array_pref = new_array_preference(default_bytes, schedule_size_limit(config) * bytes_per_item)
             
             # Create DataSensor
             sens = cg.new_Pvariable(sensor_config[CONF_ID])
@@ -184,7 +290,9 @@ async def to_code(config):
             cg.add(sens.set_label(label))
             cg.add(sens.set_item_type(item_type))
             cg.add(sens.set_max_schedule_data_entries(max_entries))
-            cg.add(sens.set_array_preference(sensor_array_pref))
+            if not config[CONF_COMBINED_STORAGE]:
+                cg.add(sens.set_array_preference(sensor_array_pref))
+            await register_data_sensor_ramp(sens, sensor_config)
             
             # Set off behavior and off value
             off_behavior_name = sensor_config.get(CONF_OFF_BEHAVIOR, "NAN")
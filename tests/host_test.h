@@ -0,0 +1,69 @@
+#pragma once
+
+// Minimal test harness for the host-side unit tests: TEST() registers a case,
+// CHECK() / CHECK_EQ() record failures without stopping the case, main() runs them all.
+
+#include <cstdio>
+#include <vector>
+
+namespace host_test {
+
+struct Case {
+  const char *name;
+  void (*fn)();
+};
+
+inline std::vector<Case> &cases() {
+  static std::vector<Case> registry;
+  return registry;
+}
+
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+struct Registrar {
+  Registrar(const char *name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+}  // namespace host_test
+
+#define TEST(name) \
+  static void name(); \
+  static host_test::Registrar name##_registrar(#name, name); \
+  static void name()
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      host_test::failures()++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { \
+    long long _a = static_cast<long long>(actual); \
+    long long _e = static_cast<long long>(expected); \
+    if (_a != _e) { \
+      std::printf("  %s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #actual, #expected, _a, \
+                  _e); \
+      host_test::failures()++; \
+    } \
+  } while (0)
+
+int main() {
+  int failed_cases = 0;
+  for (const auto &test : host_test::cases()) {
+    int before = host_test::failures();
+    test.fn();
+    bool passed = host_test::failures() == before;
+    std::printf("[%s] %s\n", passed ? " OK " : "FAIL", test.name);
+    if (!passed) {
+      failed_cases++;
+    }
+  }
+  std::printf("%d of %zu cases failed\n", failed_cases, host_test::cases().size());
+  return failed_cases == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "host_test.h"
+#include "schedule_encoding.h"
+
+using namespace esphome::schedule;
+
+static uint16_t on(uint16_t minute) { return minute | SWITCH_STATE_BIT; }
+
+// Encode events, decode them back and return the decoded table without its terminator
+static std::vector<uint16_t> round_trip(const std::vector<uint16_t> &events, bool event_based, size_t *encoded_size) {
+  uint8_t buf[256];
+  size_t size = encode_compressed_table(events.data(), events.size(), event_based, buf, sizeof(buf));
+  *encoded_size = size;
+  std::vector<uint16_t> table;
+  size_t used = decode_compressed_table(buf, size, event_based, 100, table);
+  if (used != size || table.size() < 2 || table[table.size() - 2] != 0xFFFF || table.back() != 0xFFFF) {
+    return {};
+  }
+  table.resize(table.size() - 2);
+  return table;
+}
+
+TEST(varint_boundaries) {
+  const uint32_t values[] = {0, 1, 127, 128, 16383, 16384, 2097151};
+  const size_t lengths[] = {1, 1, 1, 2, 2, 3, 3};
+  for (size_t i = 0; i < 7; i++) {
+    uint8_t buf[4];
+    size_t end = put_varint(buf, 0, sizeof(buf), values[i]);
+    CHECK_EQ(end, lengths[i]);
+    size_t pos = 0;
+    uint32_t value = 0;
+    CHECK(get_varint(buf, end, pos, value));
+    CHECK_EQ(value, values[i]);
+    CHECK_EQ(pos, end);
+  }
+}
+
+TEST(varint_rejects_truncated_and_overlong) {
+  uint8_t buf[4];
+  CHECK_EQ(put_varint(buf, 0, 1, 128), 0);
+  const uint8_t truncated[] = {0x80};
+  size_t pos = 0;
+  uint32_t value;
+  CHECK(!get_varint(truncated, sizeof(truncated), pos, value));
+  const uint8_t overlong[] = {0xFF, 0xFF, 0xFF, 0x01};
+  pos = 0;
+  CHECK(!get_varint(overlong, sizeof(overlong), pos, value));
+}
+
+TEST(state_table_round_trip) {
+  std::vector<uint16_t> events = {on(480), 720, on(1920), 2160, on(10000), 10079};
+  size_t size = 0;
+  CHECK(round_trip(events, false, &size) == events);
+  // Tag, count and one or two bytes per delta
+  CHECK(size <= 2 + 2 * events.size());
+}
+
+TEST(event_table_round_trip) {
+  std::vector<uint16_t> events = {on(0), on(60), on(61), on(5000), on(10079)};
+  size_t size = 0;
+  CHECK(round_trip(events, true, &size) == events);
+}
+
+TEST(escapes_backward_and_flagged_words) {
+  // Sunday 22:00 to Monday 06:00 runs backwards; an OFF word in an event table has the wrong flags
+  std::vector<uint16_t> state_events = {on(480), 720, on(9960), 360};
+  size_t size = 0;
+  CHECK(round_trip(state_events, false, &size) == state_events);
+  std::vector<uint16_t> event_events = {on(100), 200, on(300)};
+  CHECK(round_trip(event_events, true, &size) == event_events);
+}
+
+TEST(empty_table) {
+  size_t size = 0;
+  CHECK(round_trip({}, false, &size).empty());
+  CHECK_EQ(size, 2);
+}
+
+TEST(encode_reports_overflow) {
+  std::vector<uint16_t> events = {on(480), 720, on(1920), 2160};
+  uint8_t buf[4];
+  CHECK_EQ(encode_compressed_table(events.data(), events.size(), false, buf, sizeof(buf)), 0);
+  CHECK_EQ(encode_compressed_table(events.data(), events.size(), false, buf, 0), 0);
+}
+
+TEST(decode_rejects_invalid_input) {
+  std::vector<uint16_t> table;
+  const uint8_t wrong_tag[] = {0xD0, 0x00};
+  CHECK_EQ(decode_compressed_table(wrong_tag, sizeof(wrong_tag), false, 100, table), 0);
+  // Count larger than the table may hold
+  const uint8_t too_many[] = {COMPRESSED_FORMAT_TAG, 99};
+  CHECK_EQ(decode_compressed_table(too_many, sizeof(too_many), false, 100, table), 0);
+  // Fewer tokens than the count
+  const uint8_t short_tokens[] = {COMPRESSED_FORMAT_TAG, 3, 10, 20};
+  CHECK_EQ(decode_compressed_table(short_tokens, sizeof(short_tokens), false, 100, table), 0);
+  // Deltas past the end of the week
+  const uint8_t past_week[] = {COMPRESSED_FORMAT_TAG, 2, 0xE0, 0x4E, 0x01};
+  CHECK_EQ(decode_compressed_table(past_week, sizeof(past_week), false, 100, table), 0);
+  // Truncated escape
+  const uint8_t escape[] = {COMPRESSED_FORMAT_TAG, 1, 0x80, 0x00, 0x10};
+  CHECK_EQ(decode_compressed_table(escape, sizeof(escape), false, 100, table), 0);
+}
@@ -0,0 +1,50 @@
+#include "host_test.h"
+#include "schedule_calendar.h"
+
+#include <ctime>
+
+using esphome::schedule::epoch_week;
+
+// Days since 1 January 1970 and the calendar fields of a UTC day, via the C library
+static void civil_day(int64_t days, int &year, int &day_of_year, int &weekday) {
+  time_t ts = static_cast<time_t>(days * 86400);
+  struct tm tm {};
+  gmtime_r(&ts, &tm);
+  year = tm.tm_year + 1900;
+  day_of_year = tm.tm_yday + 1;
+  weekday = tm.tm_wday;  // 0 = Sunday
+}
+
+TEST(first_weeks_of_1970) {
+  CHECK_EQ(epoch_week(1970, 1), 0);  // Thursday 1 January
+  CHECK_EQ(epoch_week(1970, 4), 0);  // Sunday 4 January
+  CHECK_EQ(epoch_week(1970, 5), 1);  // Monday 5 January
+  CHECK_EQ(epoch_week(1970, 11), 1);
+  CHECK_EQ(epoch_week(1970, 12), 2);
+}
+
+TEST(matches_day_count_through_2105) {
+  // Every day from 1970 to the end of 2105: includes 2000 (leap) and 2100 (not leap)
+  int64_t last = 0;
+  int64_t end = 49674;  // 1 January 2106
+  for (int64_t days = 0; days < end; days++) {
+    int year, day_of_year, weekday;
+    civil_day(days, year, day_of_year, weekday);
+    uint32_t week = epoch_week(year, day_of_year);
+    CHECK_EQ(week, (days + 3) / 7);
+    // The week advances by exactly one, and only on Mondays
+    if (days > 0) {
+      CHECK_EQ(week - last, weekday == 1 ? 1 : 0);
+    }
+    last = week;
+  }
+}
+
+TEST(continuous_across_53_week_years) {
+  // 2020 has ISO week 53: Monday 28 December 2020 and Monday 4 January 2021 are one week apart
+  CHECK_EQ(epoch_week(2021, 4) - epoch_week(2020, 363), 1);
+  CHECK_EQ(epoch_week(2020, 366), epoch_week(2020, 363));
+  CHECK_EQ(epoch_week(2021, 3), epoch_week(2020, 363));
+  // A two-week rotation keeps alternating over the new year
+  CHECK((epoch_week(2021, 4) % 2) != (epoch_week(2020, 363) % 2));
+}
@@ -0,0 +1,71 @@
+#include "host_test.h"
+#include "schedule_calendar.h"
+
+#include <cstdlib>
+#include <ctime>
+
+using namespace esphome::schedule;
+
+// Central European time with its EU DST rules, from a POSIX TZ string (no zoneinfo files needed)
+static int32_t cet_offset(time_t ts) {
+  struct tm tm {};
+  localtime_r(&ts, &tm);
+  return static_cast<int32_t>(tm.tm_gmtoff);
+}
+
+static void use_cet() {
+  setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset();
+}
+
+TEST(spring_forward_gap) {
+  use_cet();
+  // Sunday 31 March 2024: 02:00 CET becomes 03:00 CEST at 01:00 UTC
+  const time_t transition = 1711846800;
+  OffsetChange change = find_offset_change(transition - 12 * 3600, cet_offset);
+  CHECK_EQ(change.timestamp, transition);
+  CHECK_EQ(change.delta_s, 3600);
+  CHECK_EQ(change.hold_minute, 1 * 60 + 59);
+}
+
+TEST(fall_back_overlap) {
+  use_cet();
+  // Sunday 27 October 2024: 03:00 CEST becomes 02:00 CET at 01:00 UTC
+  const time_t transition = 1729990800;
+  OffsetChange change = find_offset_change(transition - 20 * 3600, cet_offset);
+  CHECK_EQ(change.timestamp, transition);
+  CHECK_EQ(change.delta_s, -3600);
+  // Held at 02:59 until the repeated hour is over
+  CHECK_EQ(change.hold_minute, 2 * 60 + 59);
+}
+
+TEST(no_change_on_an_ordinary_day) {
+  use_cet();
+  OffsetChange change = find_offset_change(1718445600, cet_offset);  // 15 June 2024
+  CHECK_EQ(change.timestamp, 0);
+  CHECK_EQ(change.delta_s, 0);
+}
+
+TEST(search_window_edges) {
+  const time_t now = 1700000000;
+  // Just inside the window at both ends
+  for (time_t at : {now - 2 * 3600 + 1, now + 26 * 3600}) {
+    auto step = [at](time_t ts) { return ts < at ? 0 : 3600; };
+    CHECK_EQ(find_offset_change(now, step).timestamp, at);
+  }
+  // Just outside
+  for (time_t at : {now - 2 * 3600, now + 26 * 3600 + 1}) {
+    auto step = [at](time_t ts) { return ts < at ? 0 : 3600; };
+    CHECK_EQ(find_offset_change(now, step).delta_s, 0);
+  }
+}
+
+TEST(half_hour_offset_change) {
+  // Lord Howe Island style: +11:00 to +10:30 at 15:00 UTC (02:00 local)
+  const time_t at = 1712415600;
+  auto step = [at](time_t ts) { return ts < at ? 11 * 3600 : 10 * 3600 + 1800; };
+  OffsetChange change = find_offset_change(at - 3600, step);
+  CHECK_EQ(change.timestamp, at);
+  CHECK_EQ(change.delta_s, -1800);
+  CHECK_EQ(change.hold_minute, 1 * 60 + 59);
+}
@@ -0,0 +1,79 @@
+#include "host_test.h"
+#include "schedule_encoding.h"
+
+#include <cstring>
+
+using namespace esphome::schedule;
+
+static const uint8_t LAYOUT = 0x04;
+
+// A record with a recognisable payload and a header written over its first bytes
+static std::vector<uint8_t> make_record(size_t size) {
+  std::vector<uint8_t> record(size);
+  for (size_t i = STORAGE_HEADER_BYTES; i < size; i++) {
+    record[i] = static_cast<uint8_t>(i * 31);
+  }
+  write_storage_header(record.data(), record.size(), LAYOUT, 7, 20);
+  return record;
+}
+
+TEST(crc32_check_values) {
+  // Standard check value of CRC-32/ISO-HDLC
+  const char *digits = "123456789";
+  CHECK_EQ(crc32(reinterpret_cast<const uint8_t *>(digits), 9), 0xCBF43926u);
+  CHECK_EQ(crc32(nullptr, 0), 0);
+  const uint8_t zero = 0;
+  CHECK_EQ(crc32(&zero, 1), 0xD202EF8Du);
+}
+
+TEST(written_header_checks_ok) {
+  std::vector<uint8_t> record = make_record(64);
+  StorageHeader header{};
+  CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT, header), STORAGE_HEADER_OK);
+  CHECK_EQ(header.magic, STORAGE_HEADER_MAGIC);
+  CHECK_EQ(header.version, STORAGE_FORMAT_VERSION);
+  CHECK_EQ(header.entry_count, 7);
+  CHECK_EQ(header.payload_bytes, 20);
+  // Little-endian magic leads the record, as __init__.py assumes
+  CHECK_EQ(record[0], 0x48);
+  CHECK_EQ(record[1], 0x53);
+}
+
+TEST(every_flipped_payload_bit_fails_crc) {
+  std::vector<uint8_t> record = make_record(48);
+  StorageHeader header{};
+  for (size_t i = STORAGE_HEADER_BYTES; i < record.size(); i++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      record[i] ^= 1u << bit;
+      CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT, header), STORAGE_HEADER_BAD_CRC);
+      record[i] ^= 1u << bit;
+    }
+  }
+  CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT, header), STORAGE_HEADER_OK);
+}
+
+TEST(version_and_layout_mismatch) {
+  std::vector<uint8_t> record = make_record(32);
+  StorageHeader header{};
+  CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT | 0x80, header), STORAGE_HEADER_BAD_LAYOUT);
+  record[2] = STORAGE_FORMAT_VERSION + 1;
+  CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT, header), STORAGE_HEADER_BAD_VERSION);
+}
+
+TEST(headerless_records_are_missing) {
+  StorageHeader header{};
+  // A legacy record: raw table words, no magic
+  std::vector<uint8_t> legacy = {0xE0, 0x41, 0xD0, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0, 0, 0};
+  CHECK_EQ(check_storage_header(legacy.data(), legacy.size(), LAYOUT, header), STORAGE_HEADER_MISSING);
+  // Shorter than a header
+  std::vector<uint8_t> record = make_record(32);
+  CHECK_EQ(check_storage_header(record.data(), STORAGE_HEADER_BYTES - 1, LAYOUT, header), STORAGE_HEADER_MISSING);
+}
+
+TEST(header_only_record) {
+  std::vector<uint8_t> record(STORAGE_HEADER_BYTES);
+  write_storage_header(record.data(), record.size(), LAYOUT, 2, 0);
+  StorageHeader header{};
+  CHECK_EQ(check_storage_header(record.data(), record.size(), LAYOUT, header), STORAGE_HEADER_OK);
+  CHECK_EQ(header.crc, 0);
+}
@@ -0,0 +1,139 @@
+#include "host_test.h"
+#include "schedule_timer_wheel.h"
+
+using esphome::schedule::TimerWheel;
+using esphome::schedule::WheelTimer;
+
+// Advance until the timer fires or limit ticks pass; returns the tick it fired on (0: never)
+static uint32_t run_until_fired(TimerWheel &wheel, WheelTimer &timer, bool &fired, uint32_t limit) {
+  fired = false;
+  timer.callback = [&fired]() { fired = true; };
+  for (uint32_t i = 0; i < limit && !fired; i++) {
+    wheel.advance();
+  }
+  return fired ? wheel.now() : 0;
+}
+
+TEST(zero_delay_fires_on_next_tick) {
+  TimerWheel wheel;
+  WheelTimer timer;
+  bool fired = false;
+  timer.callback = [&fired]() { fired = true; };
+  wheel.arm(&timer, 0);
+  CHECK(timer.is_armed());
+  wheel.advance();
+  CHECK(fired);
+  CHECK(!timer.is_armed());
+  CHECK_EQ(wheel.armed_count(), 0);
+}
+
+TEST(fires_exactly_at_expiry_across_levels) {
+  // Delays on both sides of each level boundary, starting from an unaligned tick
+  const uint32_t delays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145, 604800};
+  for (uint32_t start : {0u, 37u, 4000u}) {
+    for (uint32_t delay : delays) {
+      TimerWheel wheel;
+      for (uint32_t i = 0; i < start; i++) {
+        wheel.advance();
+      }
+      WheelTimer timer;
+      bool fired = false;
+      timer.callback = [&fired]() { fired = true; };
+      wheel.arm(&timer, delay);
+      for (uint32_t i = 1; i < delay; i++) {
+        wheel.advance();
+      }
+      CHECK(!fired);
+      wheel.advance();
+      CHECK(fired);
+      CHECK_EQ(wheel.now(), start + delay);
+    }
+  }
+}
+
+TEST(many_timers_fire_in_order) {
+  TimerWheel wheel;
+  const uint32_t count = 500;
+  std::vector<WheelTimer> timers(count);
+  std::vector<uint32_t> fired_at(count, 0);
+  for (uint32_t i = 0; i < count; i++) {
+    // Spread over all four levels, several sharing a slot
+    uint32_t delay = 1 + (i * 7919u) % 300000u;
+    timers[i].callback = [&wheel, &fired_at, i]() { fired_at[i] = wheel.now(); };
+    wheel.arm(&timers[i], delay);
+  }
+  CHECK_EQ(wheel.armed_count(), count);
+  for (uint32_t tick = 0; tick < 300001; tick++) {
+    wheel.advance();
+  }
+  CHECK_EQ(wheel.armed_count(), 0);
+  for (uint32_t i = 0; i < count; i++) {
+    CHECK_EQ(fired_at[i], 1 + (i * 7919u) % 300000u);
+  }
+}
+
+TEST(cancel_prevents_firing) {
+  TimerWheel wheel;
+  WheelTimer kept, cancelled;
+  bool kept_fired = false, cancelled_fired = false;
+  kept.callback = [&kept_fired]() { kept_fired = true; };
+  cancelled.callback = [&cancelled_fired]() { cancelled_fired = true; };
+  // Same slot, so cancelling must relink the neighbour correctly
+  wheel.arm(&kept, 10);
+  wheel.arm(&cancelled, 10);
+  wheel.cancel(&cancelled);
+  CHECK(!cancelled.is_armed());
+  CHECK_EQ(wheel.armed_count(), 1);
+  wheel.cancel(&cancelled);  // Harmless when idle
+  CHECK_EQ(wheel.armed_count(), 1);
+  for (int i = 0; i < 10; i++) {
+    wheel.advance();
+  }
+  CHECK(kept_fired);
+  CHECK(!cancelled_fired);
+}
+
+TEST(rearm_moves_expiry) {
+  TimerWheel wheel;
+  WheelTimer timer;
+  bool fired = false;
+  wheel.arm(&timer, 5000);
+  wheel.arm(&timer, 3);
+  CHECK_EQ(wheel.armed_count(), 1);
+  CHECK_EQ(run_until_fired(wheel, timer, fired, 10000), 3);
+  // Nothing left to fire at the original expiry
+  for (int i = 0; i < 6000; i++) {
+    wheel.advance();
+  }
+  CHECK_EQ(wheel.armed_count(), 0);
+}
+
+TEST(callback_can_rearm_itself) {
+  TimerWheel wheel;
+  WheelTimer timer;
+  std::vector<uint32_t> fired_at;
+  timer.callback = [&]() {
+    fired_at.push_back(wheel.now());
+    if (fired_at.size() < 4) {
+      wheel.arm(&timer, 100);
+    }
+  };
+  wheel.arm(&timer, 100);
+  for (int i = 0; i < 1000; i++) {
+    wheel.advance();
+  }
+  CHECK_EQ(fired_at.size(), 4);
+  for (size_t i = 0; i < fired_at.size(); i++) {
+    CHECK_EQ(fired_at[i], 100 * (i + 1));
+  }
+}
+
+TEST(delay_is_clamped_to_max) {
+  TimerWheel wheel;
+  WheelTimer timer;
+  bool fired = false;
+  timer.callback = [&fired]() { fired = true; };
+  wheel.arm(&timer, 0xFFFFFFFF);
+  CHECK(timer.is_armed());
+  CHECK_EQ(timer.expiry, TimerWheel::MAX_DELAY);
+}
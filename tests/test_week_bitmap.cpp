@@ -0,0 +1,111 @@
+#include "host_test.h"
+#include "schedule_bitmap.h"
+#include "schedule_encoding.h"
+
+using namespace esphome::schedule;
+
+static const uint16_t END[] = {0xFFFF, 0xFFFF};
+
+static std::vector<uint16_t> table_of(std::initializer_list<uint16_t> words) {
+  std::vector<uint16_t> table(words);
+  table.insert(table.end(), END, END + 2);
+  return table;
+}
+
+static uint16_t on(uint16_t minute) { return minute | SWITCH_STATE_BIT; }
+
+TEST(set_range_covers_half_open_interval) {
+  WeekBitmap bitmap;
+  bitmap.set_range(5, 21);
+  CHECK(!bitmap.test(4));
+  CHECK(bitmap.test(5));
+  CHECK(bitmap.test(20));
+  CHECK(!bitmap.test(21));
+  CHECK(!bitmap.test(WeekBitmap::MINUTES_PER_WEEK));
+}
+
+TEST(set_range_wraps_past_end_of_week) {
+  WeekBitmap bitmap;
+  bitmap.set_range(10070, 10);
+  CHECK(bitmap.test(10079));
+  CHECK(bitmap.test(0));
+  CHECK(bitmap.test(9));
+  CHECK(!bitmap.test(10));
+  CHECK(!bitmap.test(10069));
+}
+
+TEST(table_round_trip_merges_overlapping_slots) {
+  WeekBitmap bitmap;
+  // Monday 08:00-12:00 and 11:00-13:00 overlap, Tuesday 09:00-10:00 stands alone
+  bitmap.from_table(table_of({on(480), 720, on(660), 780, on(1980), 2040}));
+  std::vector<uint16_t> table;
+  bitmap.to_table(table);
+  CHECK(table == table_of({on(480), 780, on(1980), 2040}));
+}
+
+TEST(table_round_trip_across_week_end) {
+  WeekBitmap bitmap;
+  // Sunday 22:00 until Monday 06:00
+  bitmap.from_table(table_of({on(9960), 360}));
+  std::vector<uint16_t> table;
+  bitmap.to_table(table);
+  CHECK(table == table_of({360, on(9960)}));
+}
+
+TEST(empty_and_always_on_tables) {
+  WeekBitmap bitmap;
+  std::vector<uint16_t> table;
+  bitmap.from_table(table_of({}));
+  bitmap.to_table(table);
+  CHECK(table == table_of({}));
+
+  bitmap.set_range(0, WeekBitmap::MINUTES_PER_WEEK);
+  bitmap.to_table(table);
+  CHECK(table == table_of({on(0)}));
+}
+
+TEST(rle_round_trip) {
+  WeekBitmap bitmap, decoded;
+  bitmap.from_table(table_of({on(0), 1, on(480), 1020, on(10079), 0}));
+  uint8_t buf[64];
+  size_t size = bitmap.encode_rle(buf, sizeof(buf));
+  CHECK(size > 0);
+  // Starts ON at Monday 00:00, so the first OFF run is empty
+  CHECK_EQ(buf[0] | (buf[1] << 8), 0);
+  CHECK(decoded.decode_rle(buf, size));
+  for (uint16_t minute = 0; minute < WeekBitmap::MINUTES_PER_WEEK; minute++) {
+    CHECK_EQ(decoded.test(minute), bitmap.test(minute));
+  }
+}
+
+TEST(rle_empty_bitmap_is_one_run) {
+  WeekBitmap bitmap;
+  uint8_t buf[8];
+  CHECK_EQ(bitmap.encode_rle(buf, sizeof(buf)), 2);
+  CHECK_EQ(buf[0] | (buf[1] << 8), WeekBitmap::MINUTES_PER_WEEK);
+}
+
+TEST(rle_reports_overflow) {
+  WeekBitmap bitmap;
+  // Every other minute on: far more runs than fit
+  for (uint16_t minute = 0; minute < 200; minute += 2) {
+    bitmap.set_range(minute, minute + 1);
+  }
+  uint8_t buf[16];
+  CHECK_EQ(bitmap.encode_rle(buf, sizeof(buf)), 0);
+}
+
+TEST(rle_rejects_runs_not_covering_a_week) {
+  WeekBitmap bitmap;
+  bitmap.set_range(0, 100);
+  // Short of the week
+  const uint8_t short_runs[] = {0, 0, 100, 0, 0x10, 0x27};
+  CHECK(!bitmap.decode_rle(short_runs, sizeof(short_runs)));
+  CHECK(!bitmap.test(0));
+  // Overshooting the week
+  const uint8_t long_runs[] = {0x10, 0x27, 0x64, 0x00};
+  CHECK(!bitmap.decode_rle(long_runs, sizeof(long_runs)));
+  // Truncated buffer
+  const uint8_t odd[] = {0x60};
+  CHECK(!bitmap.decode_rle(odd, sizeof(odd)));
+}